@@ -0,0 +1,254 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+/*
+ * Compares the header-only ezx::Detector with the out-of-line Context::DetectInput().
+ *
+ * Both read the same scripted input from an ezx::SimulatedBackend (buttons that are
+ * pressed and released, and a stick that sweeps in and out of its deadzone), so the
+ * difference between them is the detection itself and how the events are handed out.
+ * The context's hold events are disabled, since a Detector has none, so both paths
+ * produce the same events. Every event is consumed after each pass, and the benchmark
+ * fails if the two paths did not consume the same number of events.
+ *
+ * Usage: bench_detector [passes]
+ * */
+
+#include "backend.hpp"
+#include "clock.hpp"
+#include "context.hpp"
+#include "detector.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/*
+ * The number of different states each controller cycles through.
+ * */
+#define EZX_SCRIPT_LENGTH 240
+
+namespace
+{
+    std::vector<XINPUT_STATE> script;
+
+    /*
+     * BuildScript() returns nothing
+     *
+        * @param  The buttons the script presses.
+        * @param  Whether the script also moves the left stick, triggers and right stick.
+     *
+     * */
+    void BuildScript(
+        WORD buttons,
+        bool allAxes)
+    {
+        script.resize(EZX_SCRIPT_LENGTH);
+
+        for (int i = 0; i < EZX_SCRIPT_LENGTH; ++i)
+        {
+            XINPUT_STATE &state = script[i];
+            int sweep = (i % 60) < 30 ? (i % 60) : 60 - (i % 60);
+
+            ZeroMemory(&state, sizeof(XINPUT_STATE));
+
+            for (int bit = 0; bit < 16; ++bit)
+            {
+                if ((buttons & (1 << bit)) && ((i / (8 + bit)) & 1)) {
+                    state.Gamepad.wButtons |= (WORD)(1 << bit);
+                }
+            }
+
+            state.Gamepad.sThumbLX = (SHORT)(sweep * 1000);
+            state.Gamepad.sThumbLY = (SHORT)(-sweep * 700);
+
+            if (allAxes)
+            {
+                state.Gamepad.bLeftTrigger = (BYTE)((i * 7) % 256);
+                state.Gamepad.bRightTrigger = (BYTE)((i % 20) < 10 ? 0 : 200);
+                state.Gamepad.sThumbRX = (SHORT)(-sweep * 900);
+                state.Gamepad.sThumbRY = (SHORT)(sweep * 1100);
+            }
+        }
+    }
+
+    /*
+     * Step() returns nothing
+     *
+        * @param  The backend to update.
+        * @param  The number of connected controllers.
+        * @param  The pass number.
+     *
+     * */
+    void Step(
+        ezx::SimulatedBackend *backend,
+        int controllers,
+        long pass)
+    {
+        for (short i = 0; i < controllers; ++i) {
+            backend->SetControllerState(i, script[(pass + i * 17) % EZX_SCRIPT_LENGTH]);
+        }
+    }
+
+    /*
+     * Report() returns nothing
+     *
+        * @param  The name of the path that was measured.
+        * @param  How long all passes took, in microseconds.
+        * @param  The number of passes.
+        * @param  The number of events consumed.
+     *
+     * */
+    void Report(
+        const char *name,
+        long long elapsed,
+        long passes,
+        unsigned long events)
+    {
+        std::printf("  %-28s %8.1f ns/pass  %10lu events\n", name, 1000.0 * elapsed / passes, events);
+    }
+
+    /*
+     * RunContext() returns unsigned long
+     *
+        * @param  The number of connected controllers.
+        * @param  The number of passes to run.
+     *
+     * Returns the number of events consumed.
+     * */
+    unsigned long RunContext(
+        int controllers,
+        long passes)
+    {
+        ezx::SimulatedBackend backend;
+        ezx::Context context;
+        ezx::Event event;
+        unsigned long events = 0;
+
+        for (short i = 0; i < controllers; ++i) {
+            backend.SetConnected(i, true);
+        }
+
+        context.SetBackend(&backend);
+        context.SetHoldTiming(0, 0, 0);
+
+        long long start = ezx::GetTimestamp();
+
+        for (long pass = 0; pass < passes; ++pass)
+        {
+            Step(&backend, controllers, pass);
+            context.DetectInput();
+
+            while (context.GetEvent(&event)) {
+                ++events;
+            }
+        }
+
+        Report("Context::DetectInput()", ezx::GetTimestamp() - start, passes, events);
+        return events;
+    }
+
+    /*
+     * RunDetector() returns unsigned long
+     *
+        * @param  The number of connected controllers.
+        * @param  The number of passes to run.
+     *
+     * Reads the backend directly, as a Detector is normally given states with Detect()
+     * when they don't come from XInputGetState(). Returns the number of events consumed.
+     * */
+    template <class DetectorType>
+    unsigned long RunDetector(
+        int controllers,
+        long passes)
+    {
+        ezx::SimulatedBackend backend;
+        DetectorType detector;
+        XINPUT_STATE state;
+        ezx::Event event;
+        unsigned long events = 0;
+
+        for (short i = 0; i < controllers; ++i) {
+            backend.SetConnected(i, true);
+        }
+
+        long long start = ezx::GetTimestamp();
+
+        for (long pass = 0; pass < passes; ++pass)
+        {
+            Step(&backend, controllers, pass);
+
+            for (short i = 0; i < controllers; ++i)
+            {
+                if (backend.GetState(i, &state) == ERROR_SUCCESS) {
+                    detector.Detect(i, state);
+                } else {
+                    detector.Disconnect(i);
+                }
+            }
+
+            while (detector.policy.GetEvent(&event)) {
+                ++events;
+            }
+        }
+
+        Report("ezx::Detector", ezx::GetTimestamp() - start, passes, events);
+        return events;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long passes = argc > 1 ? std::strtol(argv[1], NULL, 10) : 1000000;
+
+    if (passes <= 0) {
+        passes = 1;
+    }
+
+    unsigned long contextEvents;
+    unsigned long detectorEvents;
+    bool matched;
+
+    std::printf("1 controller, A/B/X and the left stick:\n");
+    BuildScript(EZX_A | EZX_B | EZX_X, false);
+    contextEvents = RunContext(1, passes);
+    detectorEvents = RunDetector< ezx::Detector<1, EZX_A | EZX_B | EZX_X, EZX_AXIS_LTHUMB_X | EZX_AXIS_LTHUMB_Y> >(1, passes);
+    matched = contextEvents == detectorEvents;
+
+    std::printf("4 controllers, every button and axis:\n");
+    BuildScript(EZX_ALL_BUTTONS, true);
+    contextEvents = RunContext(4, passes);
+    detectorEvents = RunDetector< ezx::Detector<4> >(4, passes);
+    matched = matched && contextEvents == detectorEvents;
+
+    if (matched == false)
+    {
+        std::printf("the two paths consumed a different number of events\n");
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
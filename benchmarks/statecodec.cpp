@@ -0,0 +1,188 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+/*
+ * Throughput benchmark of ezx::StateEncoder and ezx::StateDecoder.
+ *
+ * Generates a stream of frames that looks like play (sticks that drift and sometimes
+ * snap, triggers that are pulled and released, occasional button presses), then times
+ * encoding all of it into one in-memory buffer and decoding it back out. The encoded
+ * size is compared with sending every PackedState in full.
+ *
+ * Usage: bench_statecodec [frames]
+ * */
+
+#include "clock.hpp"
+#include "statecodec.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    /*
+     * NextRandom() returns unsigned int
+     *
+        * @param  The state of the generator, which is advanced.
+     *
+     * A small xorshift generator, so that every run measures the same stream.
+     * */
+    unsigned int NextRandom(
+        unsigned int *state)
+    {
+        *state ^= *state << 13;
+        *state ^= *state >> 17;
+        *state ^= *state << 5;
+
+        return *state;
+    }
+
+    /*
+     * Clamp() returns int
+     *
+        * @param  The value to clamp.
+        * @param  The smallest allowed value.
+        * @param  The largest allowed value.
+     *
+     * */
+    int Clamp(
+        int value,
+        int minimum,
+        int maximum)
+    {
+        return value < minimum ? minimum : (value > maximum ? maximum : value);
+    }
+
+    /*
+     * GenerateFrames() returns nothing
+     *
+        * @param  The number of frames to generate.
+        * @param  The vector to store four states per frame in.
+     *
+     * */
+    void GenerateFrames(
+        std::size_t count,
+        std::vector<ezx::PackedState> *frames)
+    {
+        unsigned int random = 0x9E3779B9;
+        ezx::PackedState states[4];
+
+        frames->resize(count * 4);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (short j = 0; j < 4; ++j)
+            {
+                ezx::PackedState &state = states[j];
+                unsigned int roll = NextRandom(&random);
+
+                if ((roll & 31) == 0) {
+                    state.buttons ^= (WORD)(1 << (NextRandom(&random) & 15));
+                }
+
+                if ((roll & 0x700) == 0) {
+                    state.leftTrigger = (BYTE)Clamp(state.leftTrigger + (int)(NextRandom(&random) & 63) - 31, 0, 255);
+                }
+
+                if ((roll & 0x3800) == 0) {
+                    state.rightTrigger = (BYTE)Clamp(state.rightTrigger + (int)(NextRandom(&random) & 63) - 31, 0, 255);
+                }
+
+                if ((roll & 0xC000) == 0) {
+                    state.thumbLX = (SHORT)((int)(NextRandom(&random) & 0xFFFF) - 32768);
+                } else {
+                    state.thumbLX = (SHORT)Clamp(state.thumbLX + (int)(NextRandom(&random) & 1023) - 511, -32768, 32767);
+                }
+
+                state.thumbLY = (SHORT)Clamp(state.thumbLY + (int)(NextRandom(&random) & 1023) - 511, -32768, 32767);
+
+                if ((roll & 0x30000) == 0)
+                {
+                    state.thumbRX = (SHORT)Clamp(state.thumbRX + (int)(NextRandom(&random) & 4095) - 2047, -32768, 32767);
+                    state.thumbRY = (SHORT)Clamp(state.thumbRY + (int)(NextRandom(&random) & 4095) - 2047, -32768, 32767);
+                }
+
+                (*frames)[i * 4 + j] = state;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t count = argc > 1 ? (std::size_t)std::strtoul(argv[1], NULL, 10) : 1000000;
+    std::vector<ezx::PackedState> frames;
+
+    if (count == 0) {
+        count = 1;
+    }
+
+    GenerateFrames(count, &frames);
+
+    ezx::StateEncoder encoder;
+    ezx::BitWriter writer;
+
+    long long encodeStart = ezx::GetTimestamp();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        encoder.Encode(&frames[i * 4], &writer);
+    }
+
+    writer.Flush();
+
+    long long encodeTime = ezx::GetTimestamp() - encodeStart;
+
+    ezx::StateDecoder decoder;
+    ezx::BitReader reader(writer.GetData(), writer.GetSize());
+    ezx::PackedState states[4];
+    std::size_t decoded = 0;
+
+    long long decodeStart = ezx::GetTimestamp();
+
+    while (decoded < count && decoder.Decode(&reader, states)) {
+        ++decoded;
+    }
+
+    long long decodeTime = ezx::GetTimestamp() - decodeStart;
+
+    double rawBytes = (double)count * 4 * sizeof(ezx::PackedState);
+    double encodedBytes = (double)writer.GetSize();
+
+    std::printf("frames:          %lu (4 controllers each)\n", (unsigned long)count);
+    std::printf("raw size:        %.0f bytes (%.1f per frame)\n", rawBytes, rawBytes / count);
+    std::printf("encoded size:    %.0f bytes (%.2f per frame, %.1f%% of raw)\n", encodedBytes, encodedBytes / count, 100.0 * encodedBytes / rawBytes);
+    std::printf("encode:          %.1f ns/frame, %.1f MB/s of states\n", 1000.0 * encodeTime / count, encodeTime > 0 ? rawBytes / encodeTime : 0.0);
+    std::printf("decode:          %.1f ns/frame, %.1f MB/s of states\n", 1000.0 * decodeTime / count, decodeTime > 0 ? rawBytes / decodeTime : 0.0);
+
+    if (decoded != count)
+    {
+        std::printf("decoding failed after %lu frames\n", (unsigned long)decoded);
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
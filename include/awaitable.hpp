@@ -0,0 +1,176 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_AWAITABLE_HPP_
+#define _EZX_AWAITABLE_HPP_
+
+/*
+ * The awaitables need C++20 coroutines; the rest of the library only needs C++11, so this
+ * header is empty when coroutines aren't available and everything in it is inline.
+ * */
+#ifdef __cpp_impl_coroutine
+
+#include <coroutine>
+#include <stdexcept>
+
+#include "context.hpp"
+#include "waiter.hpp"
+
+namespace ezx
+{
+    /*
+     * class EventAwaiter
+     * Suspends the awaiting coroutine until the context detects an event matching the filter,
+     * then resumes it (on the thread that calls DetectInput()) with the event as the result
+     * of the co_await expression. A suspended coroutine costs nothing until then.
+     *
+     * Destroying a suspended coroutine removes its waiter from the context.
+     * Throws std::invalid_argument if the filter is invalid (see EventFilter::IsValid()), and
+     * std::logic_error from the co_await if the awaiter is already being awaited.
+     * */
+    class EventAwaiter : public EventWaiter
+    {
+    public:
+        EventAwaiter(Context &context, const EventFilter &filter)
+            : EventWaiter(filter),
+              context(&context)
+        {
+            if (filter.IsValid() == false) {
+                throw std::invalid_argument("ezx::EventAwaiter: invalid event filter");
+            }
+        }
+
+        ~EventAwaiter()
+        {
+            context->RemoveWaiter(this);
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            this->handle = handle;
+
+            if (context->AddWaiter(this) == false) {
+                throw std::logic_error("ezx::EventAwaiter: already being awaited");
+            }
+
+            return true;
+        }
+
+        Event await_resume() const noexcept
+        {
+            return event;
+        }
+
+        void Resume(const Event &event)
+        {
+            this->event = event;
+            handle.resume();
+        }
+
+    private:
+        Context                 *context;
+        std::coroutine_handle<>  handle;
+        Event                    event;
+    };
+
+    /*
+     * NextEvent() returns EventAwaiter
+     *
+        * @param  The context to wait on; the default context if omitted.
+        * @param  The events to wait for; any event if omitted.
+     *
+     * e.g. Event event = co_await ezx::NextEvent(ezx::EventFilter(EZX_CONNECT));
+     * */
+    inline EventAwaiter NextEvent(
+        Context &context,
+        const EventFilter &filter = EventFilter())
+    {
+        return EventAwaiter(context, filter);
+    }
+
+    inline EventAwaiter NextEvent(
+        const EventFilter &filter = EventFilter())
+    {
+        return EventAwaiter(GetDefaultContext(), filter);
+    }
+
+    /*
+     * ButtonPressed() returns EventAwaiter
+     *
+        * @param  The context to wait on; the default context if omitted.
+        * @param  The ID of the controller, or EZX_ANY.
+        * @param  The ID of the button, e.g. EZX_A.
+     *
+     * Waits for the button to be pressed. A button that is already held when the wait
+     * starts has to be released and pressed again.
+     * */
+    inline EventAwaiter ButtonPressed(
+        Context &context,
+        short controllerID,
+        int button)
+    {
+        return EventAwaiter(context, EventFilter(EZX_PRESS, controllerID, button, true));
+    }
+
+    inline EventAwaiter ButtonPressed(
+        short controllerID,
+        int button)
+    {
+        return EventAwaiter(GetDefaultContext(), EventFilter(EZX_PRESS, controllerID, button, true));
+    }
+
+    /*
+     * ButtonReleased() returns EventAwaiter
+     *
+        * @param  The context to wait on; the default context if omitted.
+        * @param  The ID of the controller, or EZX_ANY.
+        * @param  The ID of the button, e.g. EZX_A.
+     * */
+    inline EventAwaiter ButtonReleased(
+        Context &context,
+        short controllerID,
+        int button)
+    {
+        return EventAwaiter(context, EventFilter(EZX_RELEASE, controllerID, button));
+    }
+
+    inline EventAwaiter ButtonReleased(
+        short controllerID,
+        int button)
+    {
+        return EventAwaiter(GetDefaultContext(), EventFilter(EZX_RELEASE, controllerID, button));
+    }
+}
+
+#endif
+
+#endif
\ No newline at end of file
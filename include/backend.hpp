@@ -0,0 +1,78 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_BACKEND_HPP_
+#define _EZX_BACKEND_HPP_
+
+#include <mutex>
+
+#include "input.hpp"
+
+namespace ezx
+{
+    /*
+     * class InputBackend
+     * Where a context reads controller states from. By default contexts call
+     * XInputGetState() directly; see Context::SetBackend().
+     *
+     * GetState() may be called from several threads at once (one per controller slot)
+     * while parallel polling is enabled.
+     * */
+    class InputBackend
+    {
+    public:
+        virtual ~InputBackend() {}
+
+        virtual DWORD GetState(DWORD userIndex, XINPUT_STATE *state) = 0;
+    };
+
+    /*
+     * class SimulatedBackend
+     * A backend whose controller states are set by the program, with an optional delay
+     * added to every read of each slot. Used to test and benchmark detection without
+     * controllers, e.g. how a slow or disconnected slot affects the others.
+     * */
+    class SimulatedBackend : public InputBackend
+    {
+    public:
+        SimulatedBackend();
+
+        DWORD GetState(DWORD userIndex, XINPUT_STATE *state);
+
+        void SetControllerState(short controllerID, const XINPUT_STATE &state);
+        void SetConnected(short controllerID, bool connected);
+        void SetReadDelay(short controllerID, long long delay);
+
+    private:
+        XINPUT_STATE states[4];
+        bool         connected[4];
+        long long    readDelays[4];
+        std::mutex   mutex;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_CALIBRATION_HPP_
+#define _EZX_CALIBRATION_HPP_
+
+#include <cstddef>
+
+#include "input.hpp"
+
+/*
+ * The statistics of each axis are exponentially weighted moving averages with a weight
+ * of 1/2^EZX_CALIBRATION_SHIFT per sample (about a second of resting samples at 250Hz).
+ * */
+#define EZX_CALIBRATION_SHIFT 8
+
+/*
+ * The number of resting samples of an axis before its calibration is used.
+ * */
+#define EZX_CALIBRATION_SAMPLES 256
+
+/*
+ * A sample only counts as resting if it is within the configured deadzone of the center,
+ * and moved less than EZX_CALIBRATION_STILLNESS since the previous sample.
+ * */
+#define EZX_CALIBRATION_STILLNESS 1024
+
+/*
+ * Calibrated deadzones are EZX_CALIBRATION_NOISE_SCALE times the resting noise of the axis
+ * (its mean absolute deviation from the center), but at least EZX_CALIBRATION_MIN_DEADZONE
+ * and at most twice the configured deadzone.
+ * */
+#define EZX_CALIBRATION_NOISE_SCALE  4
+#define EZX_CALIBRATION_MIN_DEADZONE 1024
+
+/*
+ * The size of the exported form of a StickCalibration, in bytes.
+ * */
+#define EZX_CALIBRATION_SIZE 52
+
+namespace ezx
+{
+    /*
+     * class StickCalibration
+     * Streaming statistics of where each of the four stick axes of a controller rests and how
+     * much it jitters while resting, in constant memory: a center and a noise level per axis.
+     *
+     * The center is subtracted from every sample, and the deadzone of each axis is derived
+     * from its noise, so a worn stick that drifts gets a larger deadzone around its actual
+     * resting point while a good stick gets a small one.
+     *
+     * Is used in conjunction with the Context::SetStickCalibration() function.
+     * */
+    class StickCalibration
+    {
+    public:
+        StickCalibration();
+
+        void Reset();
+        void Update(const XINPUT_GAMEPAD &gamepad, const short deadzones[4]);
+        void Apply(XINPUT_GAMEPAD *gamepad) const;
+
+        bool  IsCalibrated(short axis) const;
+        short GetCenter(short axis) const;
+        short GetNoise(short axis) const;
+        short GetDeadzone(short axis, short deadzone) const;
+
+        std::size_t Export(unsigned char *buffer, std::size_t size) const;
+        bool        Import(const unsigned char *buffer, std::size_t size);
+
+    private:
+        int          centers[4];
+        int          noises[4];
+        unsigned int samples[4];
+        short        previous[4];
+    };
+}
+
+#endif
\ No newline at end of file
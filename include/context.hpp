@@ -0,0 +1,338 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_CONTEXT_HPP_
+#define _EZX_CONTEXT_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "backend.hpp"
+#include "calibration.hpp"
+#include "eventbus.hpp"
+#include "framehistory.hpp"
+#include "input.hpp"
+#include "metrics.hpp"
+#include "platform.hpp"
+#include "remap.hpp"
+#include "waiter.hpp"
+
+/*
+ * While adaptive polling is enabled, an idle controller is polled again after
+ * 1/EZX_IDLE_BACKOFF of the time it has been idle for (within the configured rates).
+ * A controller that has been idle for a second is therefore still noticed within 125ms.
+ * */
+#define EZX_IDLE_BACKOFF 8
+
+/*
+ * The default rate of the polling thread (see Context::StartPolling()), in polls per second.
+ * */
+#define EZX_POLL_RATE 250
+
+/*
+ * The default timing of the hold events (see Context::SetHoldTiming()), in milliseconds:
+ * how long a button is held before EZX_LONG_PRESS, how often EZX_REPEAT follows while it
+ * stays held, and the longest gap between two taps that still counts as EZX_DOUBLE_TAP.
+ * */
+#define EZX_LONG_PRESS_TIME  500
+#define EZX_REPEAT_INTERVAL  100
+#define EZX_DOUBLE_TAP_TIME  250
+
+/*
+ * The default thresholds of the digital trigger mode (see Context::SetDigitalTriggers()).
+ * A trigger is pressed once it reaches the press threshold and stays pressed until it falls
+ * to the release threshold, so a trigger resting near either threshold doesn't flicker.
+ * */
+#define EZX_TRIGGER_PRESS_THRESHOLD   XINPUT_GAMEPAD_TRIGGER_THRESHOLD
+#define EZX_TRIGGER_RELEASE_THRESHOLD 20
+
+/*
+ * The default hysteresis of stick directions (see Context::SetStickDirections()), in degrees:
+ * how far past the edge of its sector a stick has to move before its direction changes.
+ * */
+#define EZX_DIRECTION_HYSTERESIS 8
+
+/*
+ * The bits of the button mask (unused by XInput) that hold the triggers in digital mode.
+ * */
+#define EZX_LTRIGGER_BIT 0x0400
+#define EZX_RTRIGGER_BIT 0x0800
+#define EZX_TRIGGER_BITS (EZX_LTRIGGER_BIT | EZX_RTRIGGER_BIT)
+
+/*
+ * The default time (in microseconds) DetectInput() waits for the slot readers while
+ * parallel polling is enabled (see Context::SetParallelPolling()).
+ * */
+#define EZX_READ_TIMEOUT 1000
+
+/*
+ * The overflow policies of a bounded event queue (see Context::SetQueueLimit()).
+ * ANALOG and REPEAT events, and PRESS events that a later PRESS of the same hold
+ * supersedes, are shed first; CONNECT and DISCONNECT events, the first PRESS of each hold
+ * and the newest RELEASE of each input never are.
+ * */
+#define EZX_OVERFLOW_COALESCE    0
+#define EZX_OVERFLOW_DROP_OLDEST 1
+#define EZX_OVERFLOW_DROP_NEWEST 2
+
+/*
+ * The number of samples kept of each analog axis for Context::PredictAnalog(), and the
+ * furthest (in microseconds) a value is extrapolated past the newest sample.
+ * */
+#define EZX_ANALOG_HISTORY 8
+#define EZX_PREDICT_HORIZON 50000
+
+/*
+ * The prediction modes of Context::PredictAnalog().
+ * */
+#define EZX_PREDICT_LINEAR   0
+#define EZX_PREDICT_FILTERED 1
+
+namespace ezx
+{
+    /*
+     * class Context
+     * Owns everything the detector needs: the status of each controller, the event queue,
+     * the pipeline counters, and the detection settings.
+     *
+     * Separate contexts are completely independent and can be used on separate threads.
+     * Contexts are aligned to a cache line so that two of them never share one.
+     *
+     * Detection (DetectInput(), the Set functions) must only be done by one thread at a time,
+     * but events may be consumed (GetEvent(), WaitForEvent()) on a different thread than the
+     * one detecting them, e.g. the polling thread started by StartPolling().
+     * The free functions (ezx::DetectInput(), ezx::GetEvent(), ...) use the default context.
+     * */
+    class alignas(EZX_CACHE_LINE) Context
+    {
+    public:
+        Context();
+        ~Context();
+
+        void DetectInput();
+        void FlushEvents();
+        bool GetEvent(Event *event);
+        bool WaitForEvent(Event *event, unsigned int timeout);
+        void SetWaitSpinCount(unsigned int spinCount);
+        void SetQueueLimit(std::size_t limit, int policy = EZX_OVERFLOW_COALESCE);
+
+        bool AddWaiter(EventWaiter *waiter);
+        bool RemoveWaiter(EventWaiter *waiter);
+
+        bool StartPolling(unsigned int rate = EZX_POLL_RATE);
+        void StopPolling();
+
+        void SetBackend(InputBackend *backend);
+        void SetParallelPolling(bool enabled, unsigned int readTimeout = EZX_READ_TIMEOUT);
+
+        bool GetMetrics(Metrics *metrics) const;
+        void ResetMetrics();
+
+        void SetDeadzones(short leftThumbDeadzone, short rightThumbDeadzone);
+        void SetStickCalibration(bool enabled);
+        bool GetCalibration(short controllerID, StickCalibration *calibration) const;
+        bool SetCalibration(short controllerID, const StickCalibration &calibration);
+        void SetStickDirections(int ways, unsigned int hysteresis = EZX_DIRECTION_HYSTERESIS);
+        void SetDigitalTriggers(bool enabled, BYTE pressThreshold = EZX_TRIGGER_PRESS_THRESHOLD, BYTE releaseThreshold = EZX_TRIGGER_RELEASE_THRESHOLD);
+        void SetEventBus(EventBus *bus);
+
+        void SetButtonMap(short controllerID, const ButtonMap &map);
+        bool GetButtonMap(short controllerID, ButtonMap *map) const;
+
+        void      SetHoldTiming(unsigned int longPressTime, unsigned int repeatInterval, unsigned int doubleTapTime);
+        long long GetHoldDuration(short controllerID, int button) const;
+
+        void      SetAdaptivePolling(unsigned int minimumRate, unsigned int maximumRate);
+        long long GetPollDelay() const;
+
+        bool PredictAnalog(short controllerID, int which, long long timestamp, int mode, short *value) const;
+
+        void          SetFrameHistory(FrameHistory *history);
+        void          SetFrameNumber(unsigned long frame);
+        unsigned long GetFrameNumber() const;
+
+    private:
+        /*
+         * Arrays of statuses that are used by the detection functions.
+         * Each array is two-dimensional; one for each of the four controllers.
+         * */
+        struct Status
+        {
+            short     analogAngles[4][6];
+            bool      controllersDetected[4];
+            WORD      buttonsDown[4];
+            WORD      longPressed[4];
+            long long pressStart[4][16];
+            long long lastRelease[4][16];
+            long long nextHoldEvent[4][16];
+            long long nextHoldDue[4];
+            short     stickDirections[4][2];
+            long long sampleTime;
+            DWORD     packetNumbers[4];
+            long long lastActivity[4];
+            long long nextPoll[4];
+            PackedState packedStates[4];
+        };
+
+        /*
+         * The newest samples of one analog axis, stored as a ring.
+         * */
+        struct AnalogHistory
+        {
+            long long    times[EZX_ANALOG_HISTORY];
+            short        values[EZX_ANALOG_HISTORY];
+            unsigned int count;
+        };
+
+        /*
+         * The newest read of one controller slot by its reader thread.
+         * */
+        enum ReadPhase
+        {
+            READ_IDLE,
+            READ_REQUESTED,
+            READ_BUSY,
+            READ_DONE
+        };
+
+        struct SlotRead
+        {
+            XINPUT_STATE state;
+            DWORD        result;
+            long long    readStart;
+            long long    sampleTime;
+            long long    latency;
+            ReadPhase    phase;
+        };
+
+        /*
+         * A detected event, and whether it is the first PRESS of its hold.
+         * */
+        struct QueuedEvent
+        {
+            Event event;
+            bool  initialPress;
+        };
+
+        Status             status;
+        AnalogHistory      analogHistory[4][6];
+        std::atomic<unsigned int> historyVersions[4];
+        std::vector<QueuedEvent> pendingEvents;
+        MetricsCounters    metricsCounters;
+        short              deadzones[4];
+        StickCalibration   calibrations[4];
+        bool               calibrating;
+        int                directionWays;
+        int                directionHysteresis;
+        bool               digitalTriggers;
+        BYTE               triggerPressThreshold;
+        BYTE               triggerReleaseThreshold;
+        EventBus          *eventBus;
+        FrameHistory      *frameHistory;
+        unsigned long      frameNumber;
+        long long          fastPollInterval;
+        long long          slowPollInterval;
+        ButtonMap          buttonMaps[2][4];
+        std::atomic<int>   activeMaps;
+        std::atomic<int>   readingMaps;
+        mutable std::mutex mapMutex;
+        long long          longPressTime;
+        long long          repeatInterval;
+        long long          doubleTapTime;
+
+        std::deque<QueuedEvent>  eventQueue;
+        std::size_t              queueLimit;
+        int                      overflowPolicy;
+        std::vector<bool>        shedMarks;
+        std::vector<bool>        supersededPresses;
+        std::mutex               queueMutex;
+        std::condition_variable  queueCondition;
+        std::atomic<std::size_t> queuedEvents;
+        unsigned int             waitingConsumers;
+        unsigned int             spinCount;
+
+        EventWaiter             *waiters[EZX_EVENT_TYPE_COUNT + 1][5];
+        std::atomic<std::size_t> waiterCount;
+        std::vector<QueuedEvent> awaitedEvents;
+        std::mutex               waiterMutex;
+
+        InputBackend            *backend;
+        SlotRead                 slotReads[4];
+        std::thread              readerThreads[4];
+        std::mutex               readMutex;
+        std::condition_variable  readRequested;
+        std::condition_variable  readCompleted;
+        bool                     readersRunning;
+        long long                readTimeout;
+
+        std::thread              pollingThread;
+        std::atomic<bool>        polling;
+        InputWaiter              pollingWaiter;
+        unsigned int             pollRate;
+
+        void      PushEvent(Event event, bool initialPress = false);
+        void      RecordAnalogHistory(short controllerID, PXINPUT_STATE state);
+        void      CalibrateSticks(short controllerID, PXINPUT_STATE state);
+        short     GetDeadzone(short controllerID, short axis) const;
+        void      CommitEvents();
+        void      ResumeWaiters();
+        EventWaiter** GetWaiterList(const EventFilter &filter);
+        void      UnlinkWaiter(EventWaiter *waiter);
+        void      ShedEvents();
+        std::size_t CoalesceEvents(bool edges);
+        void      FindSupersededPresses();
+        long long GetPollingDelay() const;
+        bool      IsInputHeld() const;
+        void      PollingLoop();
+        void      WaitForPoll(long long delay);
+        DWORD     ReadState(short controllerID, PXINPUT_STATE state);
+        void      ReaderLoop(short controllerID);
+        void      StopReaders();
+        void      DetectState(short controllerID, DWORD result, PXINPUT_STATE state, long long readStart, int maps);
+        void SchedulePoll(short controllerID, bool connected, DWORD packetNumber);
+        void DetectConnection(short controllerID);
+        void DetectDisconnection(short controllerID);
+        void DetectPressedAnalog(short controllerID, short analogAngleID, short angle);
+        void DetectReleasedAnalog(short controllerID, short analogAngleID);
+        void DetectTriggers(short controllerID, PXINPUT_STATE state);
+        void DetectAnalogSticks(short controllerID, PXINPUT_STATE state);
+        void DetectStickDirections(short controllerID, PXINPUT_STATE state);
+        void DetectButtons(short controllerID, PXINPUT_STATE state);
+        void DetectHolds(short controllerID);
+
+        Context(const Context&);
+        Context& operator = (const Context&);
+    };
+
+    Context& GetDefaultContext();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,337 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_DETECTOR_HPP_
+#define _EZX_DETECTOR_HPP_
+
+#include <queue>
+
+#include "clock.hpp"
+#include "eventbus.hpp"
+#include "input.hpp"
+
+/*
+ * Masks used for the template parameters of ezx::Detector.
+ * EZX_ALL_BUTTONS enables all fourteen buttons; single buttons are enabled with their
+ * IDs, e.g. (EZX_A | EZX_B). Axes are enabled with the EZX_AXIS_ bits below.
+ * */
+#define EZX_AXIS_LTRIGGER 0x01
+#define EZX_AXIS_RTRIGGER 0x02
+#define EZX_AXIS_LTHUMB_X 0x04
+#define EZX_AXIS_LTHUMB_Y 0x08
+#define EZX_AXIS_RTHUMB_X 0x10
+#define EZX_AXIS_RTHUMB_Y 0x20
+#define EZX_ALL_AXES      0x3F
+
+/*
+ * Event type masks for the event policies of ezx::Detector.
+ * Event types that are not in a policy's mask are never generated.
+ * */
+#define EZX_EVENT_BIT(type) (1 << EZX_EVENT_TYPE_INDEX(type))
+#define EZX_ALL_EVENTS      ((1 << EZX_EVENT_TYPE_COUNT) - 1)
+
+namespace ezx
+{
+    /*
+     * class QueueEventPolicy
+     * An event policy for ezx::Detector that stores events in a queue, to be read with GetEvent().
+     * */
+    template <unsigned int Events = EZX_ALL_EVENTS>
+    struct QueueEventPolicy
+    {
+        static const unsigned int EventMask = Events;
+
+        std::queue<Event> events;
+
+        void operator () (const Event &event)
+        {
+            events.push(event);
+        }
+
+        bool GetEvent(Event *event)
+        {
+            if (event == NULL || events.empty()) {
+                return false;
+            }
+
+            *event = events.front();
+            events.pop();
+
+            return true;
+        }
+    };
+
+    /*
+     * class EventBusPolicy
+     * An event policy for ezx::Detector that publishes events to an EventBus.
+     * */
+    template <unsigned int Events = EZX_ALL_EVENTS>
+    struct EventBusPolicy
+    {
+        static const unsigned int EventMask = Events;
+
+        EventBus *bus;
+
+        explicit EventBusPolicy(EventBus *bus = NULL)
+            : bus(bus)
+        {
+            /* Intentionally left blank. */
+        }
+
+        void operator () (const Event &event)
+        {
+            bus->Publish(event);
+        }
+    };
+
+    /*
+     * class Detector
+     * A header-only detector that is specialized at compile time.
+     *
+     * Produces the same CONNECT, DISCONNECT, PRESS, RELEASE and ANALOG events as
+     * Context::DetectInput() with its default settings, in the same order, but only for the
+     * first Controllers controllers, the buttons in the Buttons mask, the axes in the Axes mask, and the event
+     * types in the EventMask of the EventPolicy. Everything else is removed by the compiler,
+     * and because the whole detector is visible to it the detection can be inlined into the
+     * caller's frame loop. Events are passed to an instance of EventPolicy, which can be any
+     * type that has an EventMask constant and can be called with a const Event&.
+     *
+     * The gestures (LONG_PRESS, REPEAT and DOUBLE_TAP), stick directions, digital triggers,
+     * remapping and stick calibration of Context are not available.
+     *
+     * For example, a single-player game that only uses A, B and the left stick:
+     *     ezx::Detector<1, EZX_A | EZX_B, EZX_AXIS_LTHUMB_X | EZX_AXIS_LTHUMB_Y> detector;
+     * */
+    template <int Controllers, WORD Buttons = EZX_ALL_BUTTONS, unsigned int Axes = EZX_ALL_AXES, class EventPolicy = QueueEventPolicy<> >
+    class Detector
+    {
+    public:
+        EventPolicy policy;
+
+        Detector()
+        {
+            Reset();
+        }
+
+        explicit Detector(const EventPolicy &policy)
+            : policy(policy)
+        {
+            Reset();
+        }
+
+        /*
+         * DetectInput() returns nothing
+         *
+         * Polls each enabled controller and builds its events.
+         * */
+        void DetectInput()
+        {
+            XINPUT_STATE state;
+
+            for (short i = 0; i < Controllers; ++i)
+            {
+                if (XInputGetState(i, &state) == ERROR_SUCCESS) {
+                    Detect(i, state);
+                } else {
+                    Disconnect(i);
+                }
+            }
+        }
+
+        /*
+         * Detect() returns nothing
+         *
+            * @param  The ID of the controller the state belongs to.
+            * @param  The state of the controller.
+         *
+         * Builds the events of a controller from a state that was read elsewhere.
+         * */
+        void Detect(
+            short controllerID,
+            const XINPUT_STATE &state)
+        {
+            long long now = GetTimestamp();
+
+            if (connected[controllerID] == false)
+            {
+                connected[controllerID] = true;
+                Push(now, Event(controllerID, EZX_CONNECT, controllerID));
+            }
+
+            DetectAnalog<2, EZX_AXIS_LTHUMB_X, EZX_LTHUMB_X>(now, controllerID, state.Gamepad.sThumbLX, XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE);
+            DetectAnalog<3, EZX_AXIS_LTHUMB_Y, EZX_LTHUMB_Y>(now, controllerID, state.Gamepad.sThumbLY, XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE);
+            DetectAnalog<4, EZX_AXIS_RTHUMB_X, EZX_RTHUMB_X>(now, controllerID, state.Gamepad.sThumbRX, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE);
+            DetectAnalog<5, EZX_AXIS_RTHUMB_Y, EZX_RTHUMB_Y>(now, controllerID, state.Gamepad.sThumbRY, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE);
+            DetectAnalog<0, EZX_AXIS_LTRIGGER, EZX_LTRIGGER>(now, controllerID, state.Gamepad.bLeftTrigger, 1);
+            DetectAnalog<1, EZX_AXIS_RTRIGGER, EZX_RTRIGGER>(now, controllerID, state.Gamepad.bRightTrigger, 1);
+
+            if (Buttons != 0) {
+                DetectButtons(now, controllerID, state.Gamepad.wButtons);
+            }
+        }
+
+        /*
+         * Disconnect() returns nothing
+         *
+            * @param  The ID of the controller that is not connected.
+         *
+         * */
+        void Disconnect(
+            short controllerID)
+        {
+            if (connected[controllerID])
+            {
+                connected[controllerID] = false;
+                Push(GetTimestamp(), Event(controllerID, EZX_DISCONNECT, controllerID));
+            }
+        }
+
+        /*
+         * Reset() returns nothing
+         *
+         * Forgets the status of every controller.
+         * */
+        void Reset()
+        {
+            for (short i = 0; i < Controllers; ++i)
+            {
+                connected[i] = false;
+                buttonsDown[i] = 0;
+
+                for (short j = 0; j < 6; ++j) {
+                    analogAngles[i][j] = 0;
+                }
+            }
+        }
+
+    private:
+        bool  connected[Controllers];
+        WORD  buttonsDown[Controllers];
+        short analogAngles[Controllers][6];
+
+        /*
+         * Push() returns nothing
+         *
+            * @param  The time the state that produced the event was sampled.
+            * @param  The event to pass to the policy.
+         *
+         * */
+        void Push(
+            long long timestamp,
+            Event event)
+        {
+            event.timestamp = timestamp;
+            policy(event);
+        }
+
+        /*
+         * DetectAnalog() returns nothing
+         *
+            * @param  The time the state was sampled.
+            * @param  The ID of the controller.
+            * @param  The current angle of the analog.
+            * @param  The smallest angle (either way) that counts as pressed.
+         *
+         * The analog's array index, mask bit and button ID are template parameters so that
+         * disabled analogs compile to nothing.
+         * */
+        template <int AnalogAngleID, unsigned int AxisBit, int ButtonID>
+        void DetectAnalog(
+            long long now,
+            short controllerID,
+            short angle,
+            short deadzone)
+        {
+            if ((Axes & AxisBit) == 0) {
+                return;
+            }
+
+            short &previous = analogAngles[controllerID][AnalogAngleID];
+
+            if (angle >= deadzone || angle <= -deadzone)
+            {
+                if ((EventPolicy::EventMask & EZX_EVENT_BIT(EZX_ANALOG)) && previous != angle) {
+                    Push(now, Event(controllerID, EZX_ANALOG, ButtonID, angle));
+                }
+
+                if (EventPolicy::EventMask & EZX_EVENT_BIT(EZX_PRESS)) {
+                    Push(now, Event(controllerID, EZX_PRESS, ButtonID, angle));
+                }
+
+                previous = angle;
+            }
+            else
+            {
+                if ((EventPolicy::EventMask & EZX_EVENT_BIT(EZX_RELEASE)) && previous != 0) {
+                    Push(now, Event(controllerID, EZX_RELEASE, ButtonID));
+                }
+
+                previous = 0;
+            }
+        }
+
+        /*
+         * DetectButtons() returns nothing
+         *
+            * @param  The time the state was sampled.
+            * @param  The ID of the controller.
+            * @param  The button mask of the state.
+         *
+         * Works on the whole button mask at once: only the set bits of the held and released
+         * masks are visited, rather than every button.
+         * */
+        void DetectButtons(
+            long long now,
+            short controllerID,
+            WORD wButtons)
+        {
+            WORD down = wButtons & Buttons;
+            WORD released = buttonsDown[controllerID] & (WORD)~down;
+
+            buttonsDown[controllerID] = down;
+
+            /*
+             * Releases come before presses, like in Context::DetectButtons().
+             * */
+            if (EventPolicy::EventMask & EZX_EVENT_BIT(EZX_RELEASE))
+            {
+                for (WORD bits = released; bits; bits &= bits - 1) {
+                    Push(now, Event(controllerID, EZX_RELEASE, bits & (WORD)(0 - bits)));
+                }
+            }
+
+            if (EventPolicy::EventMask & EZX_EVENT_BIT(EZX_PRESS))
+            {
+                for (WORD bits = down; bits; bits &= bits - 1) {
+                    Push(now, Event(controllerID, EZX_PRESS, bits & (WORD)(0 - bits)));
+                }
+            }
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -28,6 +28,20 @@
 #define _EASYXINPUT_HPP_
 
 #include "input.hpp"
+#include "awaitable.hpp"
+#include "backend.hpp"
+#include "calibration.hpp"
+#include "clock.hpp"
+#include "context.hpp"
+#include "detector.hpp"
+#include "evdev.hpp"
+#include "framehistory.hpp"
+#include "latch.hpp"
+#include "metrics.hpp"
+#include "remap.hpp"
+#include "statecodec.hpp"
+#include "vibration.hpp"
 #include "utility.hpp"
+#include "waiter.hpp"
 
 #endif
\ No newline at end of file
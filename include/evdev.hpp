@@ -0,0 +1,114 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_EVDEV_HPP_
+#define _EZX_EVDEV_HPP_
+
+#include "platform.hpp"
+
+#ifndef _WIN32
+
+#include <linux/input.h>
+
+#include <mutex>
+
+namespace ezx
+{
+    /*
+     * class EvdevBackend
+     * Reads gamepads through the Linux evdev interface (/dev/input/event*) and presents
+     * them as the four XInput controller slots.
+     *
+     * Every device descriptor, and an inotify watch on /dev/input for hot-plugging, is
+     * registered with a single epoll descriptor. Pump() drains whatever input is ready
+     * into the cached state of each slot, so reading a state never blocks, and anything
+     * waiting on GetFileDescriptor() wakes as soon as a device has new input.
+     *
+     * XInputGetState() and XInputSetState() use the backend returned by GetDefaultBackend().
+     * */
+    class EvdevBackend
+    {
+    public:
+        EvdevBackend();
+        ~EvdevBackend();
+
+        bool  Open();
+        void  Close();
+
+        short AddDevice(int descriptor, short slot = -1);
+        void  RemoveDevice(short slot);
+
+        int   Pump(int timeout, unsigned int *slots = NULL);
+
+        DWORD GetState(DWORD slot, XINPUT_STATE *state);
+        DWORD SetState(DWORD slot, XINPUT_VIBRATION *vibration);
+
+        int   GetFileDescriptor() const;
+
+    private:
+        struct AxisRange
+        {
+            int minimum;
+            int maximum;
+        };
+
+        struct Device
+        {
+            int          descriptor;
+            dev_t        node;
+            XINPUT_STATE state;
+            AxisRange    ranges[ABS_HAT0Y + 1];
+            bool         analogTriggers;
+            bool         rumble;
+            bool         dropped;
+            short        effectID;
+        };
+
+        Device     devices[4];
+        int        epollDescriptor;
+        int        notifyDescriptor;
+        std::mutex mutex;
+
+        short Attach(int descriptor, short slot);
+        bool  IsGamepad(int descriptor) const;
+        short FindDevice(dev_t node) const;
+        void  OpenPath(const char *path);
+        void  ReadDevice(short slot);
+        void  ReadNotifications();
+        void  HandleEvent(Device &device, const input_event &event);
+        void  Resync(Device &device);
+
+        EvdevBackend(const EvdevBackend&);
+        EvdevBackend& operator = (const EvdevBackend&);
+    };
+
+    EvdevBackend& GetDefaultBackend();
+}
+
+#endif
+
+#endif
\ No newline at end of file
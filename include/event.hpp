@@ -32,6 +32,17 @@
 #define EZX_ANALOG     0x0300
 #define EZX_CONNECT    0x0400
 #define EZX_DISCONNECT 0x0500
+#define EZX_LONG_PRESS 0x0600
+#define EZX_REPEAT     0x0700
+#define EZX_DOUBLE_TAP 0x0800
+#define EZX_DIRECTION  0x0900
+
+/*
+ * The number of event types above, and a macro that converts an event type
+ * into an index between 0 and EZX_EVENT_TYPE_COUNT-1 (used for per-type arrays).
+ * */
+#define EZX_EVENT_TYPE_COUNT     9
+#define EZX_EVENT_TYPE_INDEX(type) (((type) >> 8) - 1)
 
 namespace ezx
 {
@@ -40,6 +51,10 @@ namespace ezx
      * A generic catch-all object for any possible event.
      * The angle member is only used for analog events (the triggers and sticks), so it has its
      * own constructor. If not in use (i.e. a non-analog event) then angle will always equal zero.
+     * For EZX_DIRECTION events the angle is the new direction of the stick, e.g. EZX_DIR_UP.
+     *
+     * The timestamp member is the time (see ezx::GetTimestamp()) at which the controller state
+     * that produced the event was sampled.
      * */
     struct Event
     {
@@ -47,6 +62,7 @@ namespace ezx
         short controllerId;
         short angle;
         int   which;
+        long long timestamp;
 
         Event();
         Event(short controllerId, short type, int which);
@@ -0,0 +1,121 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_EVENT_BUS_HPP_
+#define _EZX_EVENT_BUS_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+#include "event.hpp"
+
+/*
+ * The default number of events an EventBus holds.
+ * Capacities are always rounded up to a power of two.
+ * */
+#define EZX_EVENT_BUS_CAPACITY 1024
+
+/*
+ * The size of a cache line. Data written by different threads is aligned to it
+ * so that it never shares a cache line.
+ * */
+#define EZX_CACHE_LINE 64
+
+namespace ezx
+{
+    /*
+     * class EventBus
+     * A fixed-size ring of events with a single producer and any number of subscribers.
+     *
+     * Each event is written into the ring once, and every EventSubscriber reads it from there
+     * using its own cursor. The producer never waits for subscribers: once the ring wraps
+     * around, the oldest events are overwritten, and a subscriber that had not read them yet
+     * finds out the next time it reads (see EventSubscriber::GetLostCount()).
+     *
+     * Is used in conjunction with the Context::SetEventBus() function.
+     * */
+    class EventBus
+    {
+    public:
+        explicit EventBus(std::size_t capacity = EZX_EVENT_BUS_CAPACITY);
+        ~EventBus();
+
+        void Publish(const Event &event);
+
+        std::size_t        GetCapacity() const;
+        unsigned long long GetOverrunCount() const;
+        unsigned long long GetSequence() const;
+
+    private:
+        friend class EventSubscriber;
+
+        struct Slot
+        {
+            std::atomic<unsigned long long> sequence;
+            Event                           event;
+        };
+
+        Slot        *slots;
+        std::size_t  mask;
+
+        alignas(EZX_CACHE_LINE) std::atomic<unsigned long long>         published;
+        alignas(EZX_CACHE_LINE) mutable std::atomic<unsigned long long> overruns;
+
+        EventBus(const EventBus&);
+        EventBus& operator = (const EventBus&);
+    };
+
+    /*
+     * class EventSubscriber
+     * A read cursor over an EventBus.
+     *
+     * A subscriber only sees events that were published after it was created.
+     * Each subscriber must only be used by one thread at a time, but any number of
+     * subscribers can read from the same bus at once without affecting each other.
+     * */
+    class EventSubscriber
+    {
+    public:
+        explicit EventSubscriber(const EventBus &bus);
+
+        bool               Peek(const Event **event);
+        bool               Advance();
+        bool               Read(Event *event);
+
+        unsigned long long GetLostCount() const;
+        unsigned long long GetPendingCount() const;
+
+    private:
+        const EventBus     *bus;
+        unsigned long long  cursor;
+        unsigned long long  lost;
+
+        void CatchUp(unsigned long long published);
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_FRAME_HISTORY_HPP_
+#define _EZX_FRAME_HISTORY_HPP_
+
+#include "input.hpp"
+
+/*
+ * The default number of frames a FrameHistory holds.
+ * Capacities are always rounded up to a power of two.
+ * */
+#define EZX_FRAME_HISTORY 128
+
+namespace ezx
+{
+    /*
+     * class PackedState
+     * The complete state of one controller in twelve bytes: the button mask,
+     * both triggers, and both axes of both analog sticks.
+     * */
+    struct PackedState
+    {
+        WORD  buttons;
+        BYTE  leftTrigger;
+        BYTE  rightTrigger;
+        SHORT thumbLX;
+        SHORT thumbLY;
+        SHORT thumbRX;
+        SHORT thumbRY;
+
+        PackedState();
+        PackedState(const XINPUT_GAMEPAD &gamepad);
+
+        bool operator == (const PackedState &other) const;
+        bool operator != (const PackedState &other) const;
+    };
+
+    /*
+     * class FrameHistory
+     * A ring of the packed states of all four controllers for each of the last N frames.
+     *
+     * All of the memory is allocated up front, and looking up a frame is a single index.
+     * When a frame is recorded it is compared with the frame before it, so whether a frame
+     * differs from the previous one is known without comparing states again.
+     *
+     * Is used in conjunction with the Context::SetFrameHistory() function, or filled directly
+     * with Record().
+     * */
+    class FrameHistory
+    {
+    public:
+        explicit FrameHistory(unsigned int capacity = EZX_FRAME_HISTORY);
+        ~FrameHistory();
+
+        void Record(unsigned long frame, const PackedState states[4], const bool connected[4]);
+
+        bool HasFrame(unsigned long frame) const;
+        bool GetState(unsigned long frame, short controllerID, PackedState *state) const;
+        bool IsConnected(unsigned long frame, short controllerID) const;
+        bool Differs(unsigned long frame) const;
+        bool Differs(unsigned long frame, short controllerID) const;
+
+        unsigned int  GetCapacity() const;
+        unsigned long GetNewestFrame() const;
+
+    private:
+        struct Frame
+        {
+            unsigned long number;
+            PackedState   states[4];
+            unsigned char connected;
+            unsigned char changed;
+            bool          valid;
+        };
+
+        Frame         *frames;
+        unsigned int   mask;
+        unsigned long  newestFrame;
+
+        const Frame* Find(unsigned long frame) const;
+
+        static unsigned char CompareFrames(const Frame *previous, const Frame &frame);
+
+        FrameHistory(const FrameHistory&);
+        FrameHistory& operator = (const FrameHistory&);
+    };
+}
+
+#endif
\ No newline at end of file
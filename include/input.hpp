@@ -27,8 +27,7 @@
 #ifndef _EZX_INPUT_HPP_
 #define _EZX_INPUT_HPP_
 
-#include <windows.h>
-#include <xinput.h>
+#include "platform.hpp"
 
 #include "connectionstates.hpp"
 #include "event.hpp"
@@ -53,6 +52,29 @@
 #define EZX_RTHUMB_Y 0x20BB
 #define EZX_LTRIGGER 0x10CC
 #define EZX_RTRIGGER 0x20CC
+#define EZX_LSTICK   0x30AA
+#define EZX_RSTICK   0x30BB
+
+/*
+ * The directions of EZX_DIRECTION events (see Context::SetStickDirections()),
+ * counter-clockwise from the right. In 4-way mode only the first four are used.
+ * */
+#define EZX_DIR_CENTER     0
+#define EZX_DIR_RIGHT      1
+#define EZX_DIR_UP         2
+#define EZX_DIR_LEFT       3
+#define EZX_DIR_DOWN       4
+#define EZX_DIR_UP_RIGHT   5
+#define EZX_DIR_UP_LEFT    6
+#define EZX_DIR_DOWN_LEFT  7
+#define EZX_DIR_DOWN_RIGHT 8
+
+/*
+ * The IDs of all fourteen buttons combined; the same bits as in XINPUT_GAMEPAD::wButtons.
+ * */
+#define EZX_ALL_BUTTONS 0xF3FF
+
+#define EZX_WAIT_INFINITE 0xFFFFFFFF
 
 namespace ezx
 {   
@@ -61,11 +83,17 @@ namespace ezx
 
     bool GetConnectionStates(ezx::ConnectionStates *states);
     bool GetEvent(Event *event);
+    bool WaitForEvent(Event *event, unsigned int timeout);
+
+    bool PredictAnalog(short controllerID, int which, long long timestamp, short *value);
 
     void SetVibrationAmount(short controllerID, WORD vibration);
     void SetVibrationAmount(short controllerID, WORD leftVibration, WORD rightVibration);
     void SetVibrationLevel(short controllerID, float vibrationPercentage);
     void SetVibrationLevel(short controllerID, float leftVibrationPercentage, float rightVibrationPercentage);
+
+    int   AnalogAngleIDToButtonID(short analogID);
+    short ButtonIDToAnalogAngleID(int buttonID);
 }
 
 #endif
\ No newline at end of file
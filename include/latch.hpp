@@ -0,0 +1,109 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_LATCH_HPP_
+#define _EZX_LATCH_HPP_
+
+#include "context.hpp"
+
+/*
+ * The default time (in microseconds) a latched sample is planned to finish before its
+ * deadline, on top of the estimated cost of the sample.
+ * */
+#define EZX_LATCH_MARGIN 250
+
+namespace ezx
+{
+    /*
+     * class LatchStatistics
+     * A snapshot of the measurements kept by a LateLatch.
+     * All times are in microseconds.
+     * */
+    struct LatchStatistics
+    {
+        unsigned long long latches;
+        unsigned long long missedDeadlines;
+        long long          readCost;
+        long long          readCostDeviation;
+        long long          wakeError;
+        long long          wakeErrorDeviation;
+        long long          framePeriod;
+        long long          frameWork;
+        long long          frameWorkDeviation;
+        unsigned long long latencyCount;
+        long long          latencyTotal;
+        long long          latencyMax;
+        long long          latencyLast;
+
+        LatchStatistics();
+    };
+
+    /*
+     * class LateLatch
+     * Detects input as late as possible before the simulation consumes it ("late latching"),
+     * instead of at the start of a frame, so the input is one frame fresher when it is presented.
+     *
+     * The latch measures the frame timeline (the frame period, and how long the application
+     * works on a frame between its sample and its present), how long DetectInput() takes and
+     * how late the thread wakes up from sleeping. From those it plans each sample to start at
+     * the latest time that still leaves the frame's work enough time before the next frame,
+     * and spends the rest of the frame's slack sleeping before the sample instead of after it.
+     * When a deadline is missed anyway, the input is still detected (late rather than not at
+     * all) and the estimates grow with the measured overrun.
+     *
+     * Must be used from the thread that runs the frame loop, and not together with
+     * Context::StartPolling() on the same context.
+     * */
+    class LateLatch
+    {
+    public:
+        explicit LateLatch(Context &context);
+
+        bool      Latch(long long deadline);
+        void      BeginFrame(long long timestamp);
+        void      Present(long long timestamp);
+
+        long long GetLatchTime(long long deadline) const;
+        long long GetNextDeadline() const;
+        long long GetSampleTime() const;
+
+        void      SetMargin(long long margin);
+        void      GetStatistics(LatchStatistics *statistics) const;
+        void      Reset();
+
+    private:
+        Context         *context;
+        long long        margin;
+        long long        sampleTime;
+        long long        sampleEnd;
+        long long        frameStart;
+        bool             presented;
+        LatchStatistics  statistics;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_METRICS_HPP_
+#define _EZX_METRICS_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+#include "event.hpp"
+
+/*
+ * The number of buckets in the device read latency histogram.
+ * Bucket 0 counts reads that took less than one microsecond; every bucket N after
+ * that counts reads that took between 2^(N-1) and 2^N microseconds.
+ * The last bucket also counts every read that was slower than that.
+ * */
+#define EZX_LATENCY_BUCKETS 16
+
+namespace ezx
+{
+    /*
+     * class Metrics
+     * A snapshot of the counters kept by the input pipeline.
+     *
+     * Is used in conjunction with the ezx::GetMetrics() function.
+     * All times are in microseconds.
+     * */
+    struct Metrics
+    {
+        unsigned long long polls[4];
+        unsigned long long readLatency[EZX_LATENCY_BUCKETS];
+        unsigned long long events[EZX_EVENT_TYPE_COUNT][4];
+        unsigned long long queueHighWater;
+        unsigned long long droppedEvents;
+        unsigned long long droppedByType[EZX_EVENT_TYPE_COUNT];
+        unsigned long long coalescedEvents;
+        unsigned long long dwellCount;
+        unsigned long long dwellTotal;
+        unsigned long long dwellMax;
+
+        Metrics();
+    };
+
+    /*
+     * class MetricsCounters
+     * The live counters behind ezx::Metrics.
+     *
+     * The poll, event, queue and drop counters are only written by the thread calling
+     * DetectInput(), so they are updated with relaxed loads and stores rather than locked
+     * read-modify-writes. This keeps the detection path cheap enough to always be enabled.
+     * The dwell counters are written by every thread calling GetEvent() or WaitForEvent(),
+     * so they use fetch_add() and a compare-exchange loop instead.
+     * */
+    class MetricsCounters
+    {
+    public:
+        MetricsCounters();
+
+        void RecordPoll(short controllerID, long long latency);
+        void RecordEvent(const Event &event);
+        void RecordQueueDepth(std::size_t depth);
+        void RecordDropped(const Event &event);
+        void RecordCoalesced(unsigned long long count);
+        void RecordDwell(long long dwell);
+
+        void Snapshot(Metrics *metrics) const;
+        void Reset();
+
+    private:
+        typedef std::atomic<unsigned long long> Counter;
+
+        Counter polls[4];
+        Counter readLatency[EZX_LATENCY_BUCKETS];
+        Counter events[EZX_EVENT_TYPE_COUNT][4];
+        Counter queueHighWater;
+        Counter droppedEvents;
+        Counter droppedByType[EZX_EVENT_TYPE_COUNT];
+        Counter coalescedEvents;
+        Counter dwellCount;
+        Counter dwellTotal;
+        Counter dwellMax;
+
+        MetricsCounters(const MetricsCounters&);
+        MetricsCounters& operator = (const MetricsCounters&);
+    };
+
+    bool GetMetrics(Metrics *metrics);
+    void ResetMetrics();
+}
+
+#endif
\ No newline at end of file
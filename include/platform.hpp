@@ -0,0 +1,141 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_PLATFORM_HPP_
+#define _EZX_PLATFORM_HPP_
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <xinput.h>
+
+#include <condition_variable>
+#include <mutex>
+
+#else
+
+#include <cstring>
+
+/*
+ * Outside of Windows the XInput types and constants used by EasyXInput are defined here,
+ * and XInputGetState()/XInputSetState() are implemented by the platform's backend
+ * (see evdev.hpp), so that the rest of the library is the same on every platform.
+ * */
+typedef unsigned long  DWORD;
+typedef unsigned short WORD;
+typedef unsigned char  BYTE;
+typedef short          SHORT;
+
+#define ERROR_SUCCESS              0L
+#define ERROR_DEVICE_NOT_CONNECTED 1167L
+
+#define ZeroMemory(destination, length) std::memset((destination), 0, (length))
+
+#define XINPUT_GAMEPAD_DPAD_UP        0x0001
+#define XINPUT_GAMEPAD_DPAD_DOWN      0x0002
+#define XINPUT_GAMEPAD_DPAD_LEFT      0x0004
+#define XINPUT_GAMEPAD_DPAD_RIGHT     0x0008
+#define XINPUT_GAMEPAD_START          0x0010
+#define XINPUT_GAMEPAD_BACK           0x0020
+#define XINPUT_GAMEPAD_LEFT_THUMB     0x0040
+#define XINPUT_GAMEPAD_RIGHT_THUMB    0x0080
+#define XINPUT_GAMEPAD_LEFT_SHOULDER  0x0100
+#define XINPUT_GAMEPAD_RIGHT_SHOULDER 0x0200
+#define XINPUT_GAMEPAD_A              0x1000
+#define XINPUT_GAMEPAD_B              0x2000
+#define XINPUT_GAMEPAD_X              0x4000
+#define XINPUT_GAMEPAD_Y              0x8000
+
+#define XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE  7849
+#define XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE 8689
+#define XINPUT_GAMEPAD_TRIGGER_THRESHOLD    30
+
+typedef struct _XINPUT_GAMEPAD
+{
+    WORD  wButtons;
+    BYTE  bLeftTrigger;
+    BYTE  bRightTrigger;
+    SHORT sThumbLX;
+    SHORT sThumbLY;
+    SHORT sThumbRX;
+    SHORT sThumbRY;
+} XINPUT_GAMEPAD, *PXINPUT_GAMEPAD;
+
+typedef struct _XINPUT_STATE
+{
+    DWORD          dwPacketNumber;
+    XINPUT_GAMEPAD Gamepad;
+} XINPUT_STATE, *PXINPUT_STATE;
+
+typedef struct _XINPUT_VIBRATION
+{
+    WORD wLeftMotorSpeed;
+    WORD wRightMotorSpeed;
+} XINPUT_VIBRATION, *PXINPUT_VIBRATION;
+
+DWORD XInputGetState(DWORD userIndex, XINPUT_STATE *state);
+DWORD XInputSetState(DWORD userIndex, XINPUT_VIBRATION *vibration);
+
+#endif
+
+namespace ezx
+{
+    /*
+     * class InputWaiter
+     * Puts a thread to sleep until new input may be available, a timeout expires,
+     * or another thread calls Wake().
+     *
+     * XInput has no way to signal new input, so on Windows this is a plain timed sleep.
+     * On Linux the sleep ends as soon as the backend has input to read (see IsEventDriven()),
+     * and that input is read before Wait() returns the slots it belongs to.
+     * */
+    class InputWaiter
+    {
+    public:
+        InputWaiter();
+        ~InputWaiter();
+
+        unsigned int Wait(long long timeout, bool watchInput = true);
+        void Wake();
+
+        static bool IsEventDriven();
+
+    private:
+#ifdef _WIN32
+        std::mutex              mutex;
+        std::condition_variable condition;
+        bool                    woken;
+#else
+        int                     wakeDescriptor;
+#endif
+
+        InputWaiter(const InputWaiter&);
+        InputWaiter& operator = (const InputWaiter&);
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_REMAP_HPP_
+#define _EZX_REMAP_HPP_
+
+#include "input.hpp"
+
+namespace ezx
+{
+    /*
+     * class ButtonMap
+     * The control layout of one controller: which button each physical button reports as,
+     * and which physical axis drives each analog axis (optionally inverted).
+     *
+     * Buttons are stored as a permutation of the bits of the button mask, and axes as one
+     * source index per axis, so a state is remapped with one table lookup per held button
+     * and one per axis. A default constructed map is the identity and costs nothing.
+     *
+     * Is used in conjunction with the Context::SetButtonMap() function.
+     * */
+    class ButtonMap
+    {
+    public:
+        ButtonMap();
+
+        bool MapButton(int from, int to);
+        bool MapAxis(int from, int to, bool inverted = false);
+        void Reset();
+
+        bool IsIdentity() const;
+        void Remap(XINPUT_GAMEPAD *gamepad) const;
+
+    private:
+        unsigned char buttonTargets[16];
+        unsigned char axisSources[6];
+        unsigned char invertedAxes;
+        bool          identity;
+
+        void UpdateIdentity();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_STATE_CODEC_HPP_
+#define _EZX_STATE_CODEC_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "framehistory.hpp"
+
+/*
+ * The default number of low bits dropped from stick and trigger values before they are
+ * encoded. Dropping four bits of a stick still leaves 4096 steps along each axis.
+ * */
+#define EZX_STICK_QUANTIZATION   4
+#define EZX_TRIGGER_QUANTIZATION 0
+
+namespace ezx
+{
+    /*
+     * class BitWriter
+     * Appends values of any width (up to 32 bits) to a byte buffer, most significant bit first.
+     * */
+    class BitWriter
+    {
+    public:
+        BitWriter();
+
+        void Write(unsigned int value, int bits);
+        void Flush();
+        void Clear();
+
+        const unsigned char* GetData() const;
+        std::size_t          GetSize() const;
+        std::size_t          GetBitCount() const;
+
+    private:
+        std::vector<unsigned char> buffer;
+        unsigned long long         accumulator;
+        int                        pendingBits;
+    };
+
+    /*
+     * class BitReader
+     * Reads the values written by a BitWriter back out of a byte buffer.
+     * Reading past the end of the buffer sets an error flag instead of reading out of bounds.
+     * The decoder also sets it when the data holds a value that no encoder could have written.
+     * */
+    class BitReader
+    {
+    public:
+        BitReader(const unsigned char *data, std::size_t size);
+
+        unsigned int Read(int bits);
+        bool         HasError() const;
+        void         SetError();
+        std::size_t  GetBitPosition() const;
+
+    private:
+        const unsigned char *data;
+        std::size_t          size;
+        std::size_t          position;
+        bool                 error;
+    };
+
+    /*
+     * class StateEncoder
+     * Writes the states of the four controllers as a bit-packed delta against the states it
+     * wrote for the previous frame.
+     *
+     * Each controller costs a single bit when it did not change. Otherwise only the fields
+     * that changed are written: the button bits that flipped, and the difference of each
+     * changed analog value after its low bits are dropped (see EZX_STICK_QUANTIZATION),
+     * as a variable-length number so that small movements take few bits.
+     *
+     * Quantization makes the encoding lossy, so the encoder tracks the states exactly as the
+     * decoder will reconstruct them (see GetReference()); errors therefore never accumulate.
+     * */
+    class StateEncoder
+    {
+    public:
+        StateEncoder(int stickQuantization = EZX_STICK_QUANTIZATION, int triggerQuantization = EZX_TRIGGER_QUANTIZATION);
+
+        void Encode(const PackedState states[4], BitWriter *writer);
+        void ForceKeyframe();
+        void Reset();
+
+        const PackedState* GetReference() const;
+
+    private:
+        PackedState reference[4];
+        int         stickQuantization;
+        int         triggerQuantization;
+        bool        keyframe;
+    };
+
+    /*
+     * class StateDecoder
+     * Reads the frames written by a StateEncoder that uses the same quantization.
+     * Frames must be decoded in the order they were encoded, starting from the first frame
+     * or from any keyframe.
+     * */
+    class StateDecoder
+    {
+    public:
+        StateDecoder(int stickQuantization = EZX_STICK_QUANTIZATION, int triggerQuantization = EZX_TRIGGER_QUANTIZATION);
+
+        bool Decode(BitReader *reader, PackedState states[4]);
+        void Reset();
+
+    private:
+        PackedState reference[4];
+        int         stickQuantization;
+        int         triggerQuantization;
+    };
+}
+
+#endif
\ No newline at end of file
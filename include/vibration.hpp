@@ -0,0 +1,92 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_VIBRATION_HPP_
+#define _EZX_VIBRATION_HPP_
+
+/*
+ * The default length of a device tick in milliseconds.
+ * Motor changes requested within one tick are coalesced into a single device write.
+ * */
+#define EZX_VIBRATION_TICK 8
+
+/*
+ * Passed as the repeat count of a VibrationEffect to make it repeat until stopped.
+ * */
+#define EZX_EFFECT_INFINITE 0
+
+namespace ezx
+{
+    /*
+     * class VibrationEffect
+     * Describes a vibration envelope that is played by ezx::PlayEffect().
+     *
+     * Each repetition of the envelope ramps up from zero to the effect's level over the
+     * attack time, holds that level over the sustain time, and then ramps back down to zero
+     * over the decay time. All times are in milliseconds.
+     *
+     * An effect with a repeat count of more than one plays as a series of pulses, one every
+     * interval milliseconds (or back to back, if the interval is shorter than the envelope).
+     * Effects playing on the same controller are added together.
+     * */
+    struct VibrationEffect
+    {
+        float        leftLevel;
+        float        rightLevel;
+        unsigned int attack;
+        unsigned int sustain;
+        unsigned int decay;
+        unsigned int repeats;
+        unsigned int interval;
+
+        VibrationEffect();
+        VibrationEffect(float level, unsigned int attack, unsigned int sustain, unsigned int decay);
+        VibrationEffect(float leftLevel, float rightLevel, unsigned int attack, unsigned int sustain, unsigned int decay);
+
+        unsigned int Period() const;
+        float        Envelope(long long elapsed) const;
+    };
+
+    int  PlayEffect(short controllerID, const VibrationEffect &effect);
+    void StopEffect(int effectID);
+    void StopEffects(short controllerID);
+
+    /*
+     * Vibration requests made with SetVibrationAmount()/SetVibrationLevel() are cached per
+     * controller; requests that match the last requested motor speeds are dropped, and the
+     * rest are written to the device by a worker thread at most once per tick.
+     *
+     * While effects are playing the same thread mixes them once per tick and writes the
+     * result to every controller that changed.
+     * */
+    void FlushVibration();
+    void ShutdownVibration();
+    void ResetVibrationCache(short controllerID);
+    void SetVibrationTick(unsigned int milliseconds);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_WAITER_HPP_
+#define _EZX_WAITER_HPP_
+
+#include "event.hpp"
+
+/*
+ * Matches any event type, controller or ID in an EventFilter.
+ * */
+#define EZX_ANY -1
+
+namespace ezx
+{
+    /*
+     * class EventFilter
+     * Which events an EventWaiter waits for. Each of the type, the controller ID and the
+     * input ID (the event's which member) is either matched exactly or EZX_ANY.
+     *
+     * Buttons fire EZX_PRESS on every poll while they are held; with initialPress set only
+     * the first EZX_PRESS of each hold of a button matches.
+     * */
+    struct EventFilter
+    {
+        short type;
+        short controllerId;
+        int   which;
+        bool  initialPress;
+
+        EventFilter(short type = EZX_ANY, short controllerId = EZX_ANY, int which = EZX_ANY, bool initialPress = false);
+
+        bool Matches(const Event &event) const;
+        bool IsValid() const;
+    };
+
+    /*
+     * class EventWaiter
+     * Something that is resumed by a context when an event matching its filter is detected,
+     * e.g. a suspended coroutine (see awaitable.hpp).
+     *
+     * A waiter is resumed once, for the first matching event, and is then no longer waiting;
+     * it has to be added again to wait for the next one.
+     *
+     * Is used in conjunction with the Context::AddWaiter() function.
+     * */
+    class EventWaiter
+    {
+    public:
+        explicit EventWaiter(const EventFilter &filter);
+        virtual ~EventWaiter() {}
+
+        virtual void Resume(const Event &event) = 0;
+
+        const EventFilter& GetFilter() const;
+
+    private:
+        friend class Context;
+
+        EventFilter  filter;
+        EventWaiter *previous;
+        EventWaiter *next;
+        bool         waiting;
+
+        EventWaiter(const EventWaiter&);
+        EventWaiter& operator = (const EventWaiter&);
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "backend.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+     * All four controllers start disconnected, with no read delay.
+     * */
+    SimulatedBackend::SimulatedBackend()
+    {
+        for (short i = 0; i < 4; ++i)
+        {
+            ZeroMemory(&states[i], sizeof(XINPUT_STATE));
+            connected[i] = false;
+            readDelays[i] = 0;
+        }
+    }
+
+    /*
+     * GetState() returns DWORD
+     *
+        * @param  The slot to read.
+        * @param  The state to fill in.
+     *
+     * Waits for the read delay of the slot, then returns the state set with
+     * SetControllerState() like XInputGetState() would.
+     * */
+    DWORD SimulatedBackend::GetState(
+        DWORD userIndex,
+        XINPUT_STATE *state)
+    {
+        if (userIndex >= 4) {
+            return ERROR_DEVICE_NOT_CONNECTED;
+        }
+
+        long long delay;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            delay = readDelays[userIndex];
+        }
+
+        if (delay > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delay));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (connected[userIndex] == false) {
+            return ERROR_DEVICE_NOT_CONNECTED;
+        }
+
+        *state = states[userIndex];
+        return ERROR_SUCCESS;
+    }
+
+    /*
+     * SetControllerState() returns nothing
+     *
+        * @param  The ID of the controller.
+        * @param  The state the controller reports from now on.
+     *
+     * The packet number of the state is increased automatically.
+     * */
+    void SimulatedBackend::SetControllerState(
+        short controllerID,
+        const XINPUT_STATE &state)
+    {
+        if (controllerID < 0 || controllerID > 3) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        DWORD packetNumber = states[controllerID].dwPacketNumber;
+
+        states[controllerID] = state;
+        states[controllerID].dwPacketNumber = packetNumber + 1;
+    }
+
+    /*
+     * SetConnected() returns nothing
+     *
+        * @param  The ID of the controller.
+        * @param  Whether the controller is plugged in.
+     * */
+    void SimulatedBackend::SetConnected(
+        short controllerID,
+        bool connected)
+    {
+        if (controllerID < 0 || controllerID > 3) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        this->connected[controllerID] = connected;
+    }
+
+    /*
+     * SetReadDelay() returns nothing
+     *
+        * @param  The ID of the controller.
+        * @param  How long every read of the controller takes, in microseconds.
+     * */
+    void SimulatedBackend::SetReadDelay(
+        short controllerID,
+        long long delay)
+    {
+        if (controllerID < 0 || controllerID > 3) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        readDelays[controllerID] = delay;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#ifndef _EZX_BUTTON_INDEX_HPP_
+#define _EZX_BUTTON_INDEX_HPP_
+
+#include "input.hpp"
+
+/*
+ * Helpers shared by the sources of the library for working with single button bits.
+ * This header is internal and is not installed with the public headers.
+ * */
+namespace ezx
+{
+    /*
+     * IsSingleButton() returns bool
+     *
+        * @param  The ID to check.
+     *
+     * Returns true if the ID is exactly one of the fourteen button bits, e.g. EZX_A.
+     * */
+    static inline bool IsSingleButton(
+        int button)
+    {
+        return (button & EZX_ALL_BUTTONS) != 0 && (button & ~EZX_ALL_BUTTONS) == 0 && (button & (button - 1)) == 0;
+    }
+
+    /*
+     * ButtonIndex() returns short
+     *
+        * @param  A single button bit, e.g. EZX_A.
+     *
+     * Converts a button bit into its index (0-15), which is used for getting/setting
+     * values from per-button arrays. Uses a de Bruijn multiplication instead of a loop.
+     * */
+    static inline short ButtonIndex(
+        WORD button)
+    {
+        static const short INDICES[32] = {
+            0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+            31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+        };
+
+        return INDICES[((unsigned int)button * 0x077CB531U) >> 27];
+    }
+}
+
+#endif
\ No newline at end of file
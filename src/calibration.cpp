@@ -0,0 +1,293 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "calibration.hpp"
+
+/*
+ * The first bytes of the exported form; the last one is the version of the format.
+ * */
+#define EZX_CALIBRATION_MAGIC "EZC\x01"
+
+namespace ezx
+{
+    /*
+     * Clamp() returns short
+     *
+        * @param  The value to clamp to the range of a stick axis.
+     * */
+    static inline short Clamp(
+        int value)
+    {
+        return (short)(value < -32768 ? -32768 : (value > 32767 ? 32767 : value));
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    StickCalibration::StickCalibration()
+    {
+        Reset();
+    }
+
+    /*
+     * Reset() returns nothing
+     *
+     * Forgets everything that was learned.
+     * */
+    void StickCalibration::Reset()
+    {
+        for (short i = 0; i < 4; ++i)
+        {
+            centers[i] = 0;
+            noises[i] = 0;
+            samples[i] = 0;
+            previous[i] = 0;
+        }
+    }
+
+    /*
+     * Update() returns nothing
+     *
+        * @param  The raw gamepad state that was just read.
+        * @param  The configured deadzones of the four stick axes (LX, LY, RX, RY).
+     *
+     * Adds the sample to the statistics of each stick that is resting. Both axes of a stick
+     * have to be within the configured deadzone of the center and still for the stick to
+     * count as resting, so neither moving a stick through the center nor holding a steady
+     * tilt (e.g. to walk slowly) pulls the statistics around.
+     * */
+    void StickCalibration::Update(
+        const XINPUT_GAMEPAD &gamepad,
+        const short deadzones[4])
+    {
+        short values[4] = {gamepad.sThumbLX, gamepad.sThumbLY, gamepad.sThumbRX, gamepad.sThumbRY};
+        bool resting[4];
+
+        for (short i = 0; i < 4; ++i)
+        {
+            int offset = values[i] - GetCenter(i);
+            int movement = values[i] - previous[i];
+
+            resting[i] = offset < deadzones[i] && offset > -deadzones[i]
+                      && movement < EZX_CALIBRATION_STILLNESS && movement > -EZX_CALIBRATION_STILLNESS;
+            previous[i] = values[i];
+        }
+
+        for (short i = 0; i < 4; ++i)
+        {
+            if (resting[i & ~1] == false || resting[i | 1] == false) {
+                continue;
+            }
+
+            int value = values[i] * (1 << EZX_CALIBRATION_SHIFT);
+
+            if (samples[i] == 0) {
+                centers[i] = value;
+            } else {
+                centers[i] += (value - centers[i]) / (1 << EZX_CALIBRATION_SHIFT);
+            }
+
+            int deviation = value - centers[i];
+
+            if (deviation < 0) {
+                deviation = -deviation;
+            }
+
+            noises[i] += (deviation - noises[i]) / (1 << EZX_CALIBRATION_SHIFT);
+
+            if (samples[i] < EZX_CALIBRATION_SAMPLES) {
+                ++samples[i];
+            }
+        }
+    }
+
+    /*
+     * Apply() returns nothing
+     *
+        * @param  The gamepad state to correct.
+     *
+     * Subtracts the resting center of every calibrated axis from the state.
+     * */
+    void StickCalibration::Apply(
+        XINPUT_GAMEPAD *gamepad) const
+    {
+        SHORT *values[4] = {&gamepad->sThumbLX, &gamepad->sThumbLY, &gamepad->sThumbRX, &gamepad->sThumbRY};
+
+        for (short i = 0; i < 4; ++i) {
+            if (IsCalibrated(i)) {
+                *values[i] = Clamp(*values[i] - GetCenter(i));
+            }
+        }
+    }
+
+    /*
+     * IsCalibrated() returns bool
+     *
+        * @param  The axis: 0-3 for LX, LY, RX and RY.
+     *
+     * Returns true once the axis has enough resting samples for its calibration to be used.
+     * */
+    bool StickCalibration::IsCalibrated(
+        short axis) const
+    {
+        return samples[axis] >= EZX_CALIBRATION_SAMPLES;
+    }
+
+    /*
+     * GetCenter() returns short
+     *
+        * @param  The axis: 0-3 for LX, LY, RX and RY.
+     *
+     * Returns the value the axis rests at.
+     * */
+    short StickCalibration::GetCenter(
+        short axis) const
+    {
+        return Clamp(centers[axis] / (1 << EZX_CALIBRATION_SHIFT));
+    }
+
+    /*
+     * GetNoise() returns short
+     *
+        * @param  The axis: 0-3 for LX, LY, RX and RY.
+     *
+     * Returns the mean absolute deviation of the axis from its center while resting.
+     * */
+    short StickCalibration::GetNoise(
+        short axis) const
+    {
+        return Clamp(noises[axis] / (1 << EZX_CALIBRATION_SHIFT));
+    }
+
+    /*
+     * GetDeadzone() returns short
+     *
+        * @param  The axis: 0-3 for LX, LY, RX and RY.
+        * @param  The configured deadzone of the axis, returned while it is not calibrated.
+     * */
+    short StickCalibration::GetDeadzone(
+        short axis,
+        short deadzone) const
+    {
+        if (IsCalibrated(axis) == false) {
+            return deadzone;
+        }
+
+        int calibrated = GetNoise(axis) * EZX_CALIBRATION_NOISE_SCALE;
+
+        if (calibrated < EZX_CALIBRATION_MIN_DEADZONE) {
+            calibrated = EZX_CALIBRATION_MIN_DEADZONE;
+        } else if (calibrated > 2 * deadzone) {
+            calibrated = 2 * deadzone;
+        }
+
+        return Clamp(calibrated);
+    }
+
+    /*
+     * Export() returns std::size_t
+     *
+        * @param  The buffer to write the calibration to.
+        * @param  The size of the buffer; at least EZX_CALIBRATION_SIZE bytes.
+     *
+     * Writes the calibration in a portable form (little endian, with a version number) so it
+     * can be saved and restored with Import() in a later session.
+     * Returns the number of bytes written, or 0 if the buffer is too small.
+     * */
+    std::size_t StickCalibration::Export(
+        unsigned char *buffer,
+        std::size_t size) const
+    {
+        if (buffer == NULL || size < EZX_CALIBRATION_SIZE) {
+            return 0;
+        }
+
+        unsigned char *position = buffer;
+
+        for (short i = 0; i < 4; ++i) {
+            *position++ = (unsigned char)EZX_CALIBRATION_MAGIC[i];
+        }
+
+        for (short i = 0; i < 4; ++i)
+        {
+            unsigned int fields[3] = {(unsigned int)centers[i], (unsigned int)noises[i], samples[i]};
+
+            for (short j = 0; j < 3; ++j) {
+                for (short k = 0; k < 4; ++k) {
+                    *position++ = (unsigned char)(fields[j] >> (8 * k));
+                }
+            }
+        }
+
+        return EZX_CALIBRATION_SIZE;
+    }
+
+    /*
+     * Import() returns bool
+     *
+        * @param  A calibration written by Export().
+        * @param  The size of the buffer.
+     *
+     * Will return false (and leave the calibration unchanged) if the buffer does not hold
+     * a calibration in the current format.
+     * */
+    bool StickCalibration::Import(
+        const unsigned char *buffer,
+        std::size_t size)
+    {
+        if (buffer == NULL || size < EZX_CALIBRATION_SIZE) {
+            return false;
+        }
+
+        for (short i = 0; i < 4; ++i) {
+            if (buffer[i] != (unsigned char)EZX_CALIBRATION_MAGIC[i]) {
+                return false;
+            }
+        }
+
+        const unsigned char *position = buffer + 4;
+
+        for (short i = 0; i < 4; ++i)
+        {
+            unsigned int fields[3] = {0, 0, 0};
+
+            for (short j = 0; j < 3; ++j) {
+                for (short k = 0; k < 4; ++k) {
+                    fields[j] |= (unsigned int)*position++ << (8 * k);
+                }
+            }
+
+            centers[i] = (int)fields[0];
+            noises[i] = (int)fields[1];
+            samples[i] = fields[2] < EZX_CALIBRATION_SAMPLES ? fields[2] : EZX_CALIBRATION_SAMPLES;
+            previous[i] = GetCenter(i);
+        }
+
+        return true;
+    }
+}
\ No newline at end of file
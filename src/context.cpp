@@ -0,0 +1,2411 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "context.hpp"
+#include "buttonindex.hpp"
+#include "clock.hpp"
+#include "vibration.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+/*
+ * Some macros that make the code below a little easier to read.
+ * All of them are used for creating arrays.
+ * */
+#define EZX_ANALOG_STICK_ANGLES(state) {(state).Gamepad.sThumbLX, (state).Gamepad.sThumbLY, (state).Gamepad.sThumbRX, (state).Gamepad.sThumbRY}
+#define EZX_TRIGGER_ANGLES(state)      {(state).Gamepad.bLeftTrigger, (state).Gamepad.bRightTrigger}
+
+/*
+ * The units of the integer "diamond angle" used to quantize stick directions: a full turn
+ * is 4 * EZX_DIAMOND_QUADRANT. EZX_DIAMOND_22_5 is the diamond angle of 22.5 degrees.
+ * */
+#define EZX_DIAMOND_QUADRANT 4096
+#define EZX_DIAMOND_22_5     1200
+
+/*
+ * The number of distinct inputs per controller an overflowing queue tells apart when it
+ * coalesces events: 16 button bits, the six analogs and the two stick directions.
+ * */
+#define EZX_SHED_SLOTS 24
+
+namespace ezx
+{
+    /*
+     * ButtonBitToID() returns int
+     *
+        * @param  A single bit of the button mask.
+     *
+     * Returns the button ID of the bit, which is the bit itself except for the trigger bits
+     * of the digital trigger mode (which become EZX_LTRIGGER and EZX_RTRIGGER).
+     * */
+    static inline int ButtonBitToID(
+        WORD bit)
+    {
+        switch (bit)
+        {
+        case EZX_LTRIGGER_BIT: return EZX_LTRIGGER;
+        case EZX_RTRIGGER_BIT: return EZX_RTRIGGER;
+        default:               return bit;
+        }
+    }
+
+    /*
+     * ButtonIDToBit() returns WORD
+     *
+        * @param  The button ID, e.g. EZX_A or EZX_LTRIGGER.
+     *
+     * The inverse of ButtonBitToID(). Returns 0 if the ID is not a single button.
+     * */
+    static inline WORD ButtonIDToBit(
+        int buttonID)
+    {
+        switch (buttonID)
+        {
+        case EZX_LTRIGGER: return EZX_LTRIGGER_BIT;
+        case EZX_RTRIGGER: return EZX_RTRIGGER_BIT;
+        }
+
+        if (IsSingleButton(buttonID) == false) {
+            return 0;
+        }
+
+        return (WORD)buttonID;
+    }
+
+    /*
+     * DiamondAngle() returns int
+     *
+        * @param  The X axis of the stick.
+        * @param  The Y axis of the stick.
+     *
+     * Returns an angle between 0 and 4 * EZX_DIAMOND_QUADRANT (counter-clockwise from the
+     * right) that increases with the true angle of the stick, using one division instead of
+     * atan2(). Within each quadrant the angle is |y| / (|x| + |y|).
+     * The stick must not be exactly centered.
+     * */
+    static inline int DiamondAngle(
+        int x,
+        int y)
+    {
+        int ax = x < 0 ? -x : x;
+        int ay = y < 0 ? -y : y;
+        int t = (int)((long long)ay * EZX_DIAMOND_QUADRANT / (ax + ay));
+
+        if (y >= 0) {
+            return x >= 0 ? t : 2 * EZX_DIAMOND_QUADRANT - t;
+        } else {
+            return x < 0 ? 2 * EZX_DIAMOND_QUADRANT + t : (4 * EZX_DIAMOND_QUADRANT - t) % (4 * EZX_DIAMOND_QUADRANT);
+        }
+    }
+
+    /*
+     * ShedTier() returns int
+     *
+        * @param  An event in the event queue.
+     *
+        * @param  Whether a PRESS event is the first one of its hold.
+        * @param  Whether a PRESS event is followed by another PRESS of the same hold.
+     *
+     * Returns 1 for the events a full queue sheds first (ANALOG and REPEAT, which are repeated
+     * while the input is held, and PRESS events that repeat a press and are superseded by a
+     * later one), 2 for gesture events (LONG_PRESS and DOUBLE_TAP), and 0 for the events that
+     * are never dropped. The first PRESS of a hold is never dropped, so a consumer never sees
+     * a RELEASE without a PRESS.
+     * */
+    static inline int ShedTier(
+        const Event &event,
+        bool initialPress,
+        bool superseded)
+    {
+        switch (event.type)
+        {
+        case EZX_PRESS:
+            return initialPress == false && superseded ? 1 : 0;
+
+        case EZX_ANALOG:
+        case EZX_REPEAT:
+            return 1;
+
+        case EZX_LONG_PRESS:
+        case EZX_DOUBLE_TAP:
+            return 2;
+
+        default:
+            return 0;
+        }
+    }
+
+    /*
+     * CoalesceKind() returns int
+     *
+        * @param  An event in the event queue.
+        * @param  Whether edge events (RELEASE, DIRECTION) are being coalesced, rather than
+        *         held events (PRESS, ANALOG, REPEAT).
+     *
+     * Returns an index between 0 and 2 for the events that can be superseded by a newer event
+     * of the same type and input, or -1 for every other event.
+     * */
+    static inline int CoalesceKind(
+        const Event &event,
+        bool edges)
+    {
+        switch (event.type)
+        {
+        case EZX_PRESS:     return edges ? -1 : 0;
+        case EZX_ANALOG:    return edges ? -1 : 1;
+        case EZX_REPEAT:    return edges ? -1 : 2;
+        case EZX_RELEASE:   return edges ? 0 : -1;
+        case EZX_DIRECTION: return edges ? 1 : -1;
+        default:            return -1;
+        }
+    }
+
+    /*
+     * ShedSlot() returns int
+     *
+        * @param  An event in the event queue.
+     *
+     * Returns an index between 0 and EZX_SHED_SLOTS-1 for the input of a button, analog or
+     * direction event (the bit index of a button, 16 plus the analog ID, or 22 and 23 for
+     * the sticks), or -1 for other events.
+     * */
+    static inline int ShedSlot(
+        const Event &event)
+    {
+        if (event.controllerId < 0 || event.controllerId > 3 || event.type == EZX_CONNECT || event.type == EZX_DISCONNECT) {
+            return -1;
+        }
+
+        short analogID = ButtonIDToAnalogAngleID(event.which);
+
+        if (analogID >= 0) {
+            return 16 + analogID;
+        }
+
+        switch (event.which)
+        {
+        case EZX_LSTICK: return 22;
+        case EZX_RSTICK: return 23;
+        }
+
+        if (event.which > 0 && event.which <= 0xFFFF && (event.which & (event.which - 1)) == 0) {
+            return ButtonIndex((WORD)event.which);
+        }
+
+        return -1;
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    Context::Context()
+        : calibrating(false),
+          directionWays(0),
+          directionHysteresis(0),
+          digitalTriggers(false),
+          triggerPressThreshold(EZX_TRIGGER_PRESS_THRESHOLD),
+          triggerReleaseThreshold(EZX_TRIGGER_RELEASE_THRESHOLD),
+          eventBus(NULL),
+          frameHistory(NULL),
+          frameNumber(0),
+          fastPollInterval(0),
+          slowPollInterval(0),
+          activeMaps(0),
+          readingMaps(-1),
+          longPressTime(EZX_LONG_PRESS_TIME * 1000LL),
+          repeatInterval(EZX_REPEAT_INTERVAL * 1000LL),
+          doubleTapTime(EZX_DOUBLE_TAP_TIME * 1000LL),
+          queueLimit(0),
+          overflowPolicy(EZX_OVERFLOW_COALESCE),
+          queuedEvents(0),
+          waitingConsumers(0),
+          spinCount(0),
+          waiterCount(0),
+          backend(NULL),
+          readersRunning(false),
+          readTimeout(EZX_READ_TIMEOUT),
+          polling(false),
+          pollRate(EZX_POLL_RATE)
+    {
+        status = Status();
+        std::memset(analogHistory, 0, sizeof(analogHistory));
+        std::memset(waiters, 0, sizeof(waiters));
+
+        for (short i = 0; i < 4; ++i) {
+            historyVersions[i].store(0);
+        }
+
+        SetDeadzones(XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE);
+    }
+
+    /*
+     * Destructor
+     *
+     * Stops the polling thread and the slot readers if they are running.
+     * */
+    Context::~Context()
+    {
+        StopPolling();
+        StopReaders();
+    }
+
+    /*
+     * PushEvent() returns nothing
+     *
+        * @param  The event to add to the event queue.
+        * @param  Whether a PRESS event is the first one of its hold.
+     *
+     * Stamps the event with the time the current controller state was sampled and publishes
+     * it if an event bus is set. Otherwise the event is held until the end of DetectInput(),
+     * when every event of the pass is added to the event queue at once by CommitEvents().
+     * */
+    inline void Context::PushEvent(
+        Event event,
+        bool initialPress)
+    {
+        event.timestamp = status.sampleTime;
+        metricsCounters.RecordEvent(event);
+
+        QueuedEvent queued = {event, initialPress};
+
+        if (waiterCount.load(std::memory_order_relaxed) > 0) {
+            awaitedEvents.push_back(queued);
+        }
+
+        if (eventBus) {
+            eventBus->Publish(event);
+        } else {
+            pendingEvents.push_back(queued);
+        }
+    }
+
+    /*
+     * CommitEvents() returns nothing
+     *
+     * Moves the events detected by the current pass into the event queue under a single lock,
+     * then wakes any consumer that is blocked in WaitForEvent().
+     * */
+    void Context::CommitEvents()
+    {
+        if (pendingEvents.empty()) {
+            return;
+        }
+
+        bool wake;
+        std::size_t depth;
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+
+            /*
+             * A refused PRESS that is not the first of its hold is superseded by the PRESS the
+             * consumer already has.
+             * */
+            for (std::vector<QueuedEvent>::const_iterator itr = pendingEvents.begin(); itr != pendingEvents.end(); itr++)
+            {
+                if (queueLimit > 0 && overflowPolicy == EZX_OVERFLOW_DROP_NEWEST && eventQueue.size() >= queueLimit && ShedTier(itr->event, itr->initialPress, true) == 1) {
+                    metricsCounters.RecordDropped(itr->event);
+                } else {
+                    eventQueue.push_back(*itr);
+                }
+            }
+
+            if (queueLimit > 0 && eventQueue.size() > queueLimit) {
+                ShedEvents();
+            }
+
+            depth = eventQueue.size();
+            wake = waitingConsumers > 0;
+            queuedEvents.store(depth, std::memory_order_release);
+        }
+
+        pendingEvents.clear();
+        metricsCounters.RecordQueueDepth(depth);
+
+        if (wake) {
+            queueCondition.notify_all();
+        }
+    }
+
+    /*
+     * ResumeWaiters() returns nothing
+     *
+     * Resumes every waiter whose filter matches an event of the current pass, in the order
+     * of the events. Only the four lists an event can match are searched (its type or any type,
+     * its controller or any controller), so waiters for other input cost nothing.
+     * The waiters are resumed after the waiter mutex is released, so they may add themselves
+     * (or other waiters) again right away.
+     * */
+    void Context::ResumeWaiters()
+    {
+        if (awaitedEvents.empty()) {
+            return;
+        }
+
+        std::vector<std::pair<EventWaiter*, Event> > resumed;
+
+        {
+            std::lock_guard<std::mutex> lock(waiterMutex);
+
+            for (std::vector<QueuedEvent>::const_iterator itr = awaitedEvents.begin(); itr != awaitedEvents.end() && waiterCount.load() > 0; itr++)
+            {
+                const Event &event = itr->event;
+                short typeIndex = EZX_EVENT_TYPE_INDEX(event.type) + 1;
+                EventWaiter **lists[4] = {
+                    &waiters[typeIndex][event.controllerId], &waiters[typeIndex][4],
+                    &waiters[0][event.controllerId],         &waiters[0][4]
+                };
+
+                for (short i = 0; i < 4; ++i)
+                {
+                    EventWaiter *waiter = *lists[i];
+
+                    while (waiter)
+                    {
+                        EventWaiter *next = waiter->next;
+                        const EventFilter &filter = waiter->filter;
+
+                        if (filter.Matches(event) && (filter.initialPress == false || event.type != EZX_PRESS || itr->initialPress))
+                        {
+                            UnlinkWaiter(waiter);
+                            resumed.push_back(std::make_pair(waiter, event));
+                        }
+
+                        waiter = next;
+                    }
+                }
+            }
+        }
+
+        awaitedEvents.clear();
+
+        for (std::size_t i = 0; i < resumed.size(); ++i) {
+            resumed[i].first->Resume(resumed[i].second);
+        }
+    }
+
+    /*
+     * GetWaiterList() returns EventWaiter**
+     *
+        * @param  The filter of a waiter.
+     *
+     * Returns the head of the list that waiters with the filter are kept in, or NULL if the
+     * filter is invalid (see EventFilter::IsValid()). Is called with the waiter mutex held.
+     * */
+    EventWaiter** Context::GetWaiterList(
+        const EventFilter &filter)
+    {
+        if (filter.IsValid() == false) {
+            return NULL;
+        }
+
+        int typeIndex = filter.type == EZX_ANY ? 0 : EZX_EVENT_TYPE_INDEX(filter.type) + 1;
+        int controllerIndex = filter.controllerId == EZX_ANY ? 4 : filter.controllerId;
+
+        return &waiters[typeIndex][controllerIndex];
+    }
+
+    /*
+     * UnlinkWaiter() returns nothing
+     *
+        * @param  A waiter that is waiting.
+     *
+     * Is called with the waiter mutex held.
+     * */
+    void Context::UnlinkWaiter(
+        EventWaiter *waiter)
+    {
+        if (waiter->previous) {
+            waiter->previous->next = waiter->next;
+        } else {
+            *GetWaiterList(waiter->filter) = waiter->next;
+        }
+
+        if (waiter->next) {
+            waiter->next->previous = waiter->previous;
+        }
+
+        waiter->previous = NULL;
+        waiter->next = NULL;
+        waiter->waiting = false;
+        waiterCount.fetch_sub(1);
+    }
+
+    /*
+     * ShedEvents() returns nothing
+     *
+     * Brings an event queue that is over its limit back down to the limit (see SetQueueLimit()).
+     * Is called with the queue mutex held. Each step only runs while the queue is still over:
+     *
+     * 1. With EZX_OVERFLOW_COALESCE, every PRESS, ANALOG or REPEAT event that is superseded by
+     *    a newer one of the same input is removed. Nothing is lost; the newer event carries
+     *    the same information (and becomes the first PRESS of the hold if the removed one was).
+     * 2. The oldest ANALOG and REPEAT events, and PRESS events that repeat a press and are
+     *    followed by another PRESS of the same hold, are dropped. (With EZX_OVERFLOW_DROP_NEWEST
+     *    new ones were already refused, so this only happens once the queue is full of edges.)
+     * 3. The oldest LONG_PRESS and DOUBLE_TAP events are dropped.
+     * 4. A RELEASE or DIRECTION event that is followed by another one of the same input,
+     *    with nothing of that input in between, is removed; the consumer ends up in the same
+     *    state either way.
+     *
+     * CONNECT and DISCONNECT events, the first PRESS of each hold, and the newest RELEASE and
+     * DIRECTION of each input, are never removed, so a consumer never misses a change of state.
+     * */
+    void Context::ShedEvents()
+    {
+        std::size_t size = eventQueue.size();
+        std::size_t removed = 0;
+
+        shedMarks.assign(size, false);
+
+        if (overflowPolicy == EZX_OVERFLOW_COALESCE) {
+            removed += CoalesceEvents(false);
+        }
+
+        FindSupersededPresses();
+
+        for (int tier = 1; tier <= 2; ++tier)
+        {
+            for (std::size_t i = 0; i < size && size - removed > queueLimit; ++i)
+            {
+                if (shedMarks[i] == false && ShedTier(eventQueue[i].event, eventQueue[i].initialPress, supersededPresses[i]) == tier)
+                {
+                    shedMarks[i] = true;
+                    metricsCounters.RecordDropped(eventQueue[i].event);
+                    ++removed;
+                }
+            }
+        }
+
+        if (size - removed > queueLimit) {
+            removed += CoalesceEvents(true);
+        }
+
+        std::size_t kept = 0;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            if (shedMarks[i] == false) {
+                eventQueue[kept++] = eventQueue[i];
+            }
+        }
+
+        eventQueue.resize(kept);
+    }
+
+    /*
+     * CoalesceEvents() returns std::size_t
+     *
+        * @param  Whether to coalesce edge events (RELEASE, DIRECTION) rather than held events
+        *         (PRESS, ANALOG, REPEAT).
+     *
+     * Marks every event in the queue that is superseded by a newer event of the same type and
+     * input, with no other event of that input in between. A newer PRESS takes over the first
+     * PRESS flag of the one it supersedes. Returns the number of events marked.
+     * Is called by ShedEvents() with the queue mutex held.
+     * */
+    std::size_t Context::CoalesceEvents(
+        bool edges)
+    {
+        std::size_t newest[3][4][EZX_SHED_SLOTS];
+        std::size_t coalesced = 0;
+
+        std::memset(newest, 0, sizeof(newest));
+
+        for (std::size_t i = eventQueue.size(); i-- > 0;)
+        {
+            const Event &event = eventQueue[i].event;
+            int slot = ShedSlot(event);
+
+            if (shedMarks[i] || slot < 0) {
+                continue;
+            }
+
+            int kind = CoalesceKind(event, edges);
+
+            /*
+             * The index of the newest event of each kind is stored plus one, so zero means none.
+             * */
+            if (kind < 0)
+            {
+                newest[0][event.controllerId][slot] = 0;
+                newest[1][event.controllerId][slot] = 0;
+                newest[2][event.controllerId][slot] = 0;
+            }
+            else if (newest[kind][event.controllerId][slot])
+            {
+                if (eventQueue[i].initialPress) {
+                    eventQueue[newest[kind][event.controllerId][slot] - 1].initialPress = true;
+                }
+
+                shedMarks[i] = true;
+                ++coalesced;
+            }
+            else
+            {
+                newest[kind][event.controllerId][slot] = i + 1;
+            }
+        }
+
+        metricsCounters.RecordCoalesced(coalesced);
+        return coalesced;
+    }
+
+    /*
+     * FindSupersededPresses() returns nothing
+     *
+     * Marks every PRESS event in the queue that is followed by another PRESS of the same input
+     * before that input's next RELEASE, i.e. one that a consumer can miss without its view of
+     * the input changing. Events already marked for removal are skipped.
+     * Is called by ShedEvents() with the queue mutex held.
+     * */
+    void Context::FindSupersededPresses()
+    {
+        bool pressed[4][EZX_SHED_SLOTS];
+
+        std::memset(pressed, 0, sizeof(pressed));
+        supersededPresses.assign(eventQueue.size(), false);
+
+        for (std::size_t i = eventQueue.size(); i-- > 0;)
+        {
+            const Event &event = eventQueue[i].event;
+            int slot = ShedSlot(event);
+
+            if (shedMarks[i] || slot < 0) {
+                continue;
+            }
+
+            if (event.type == EZX_PRESS)
+            {
+                supersededPresses[i] = pressed[event.controllerId][slot];
+                pressed[event.controllerId][slot] = true;
+            }
+            else if (event.type == EZX_RELEASE)
+            {
+                pressed[event.controllerId][slot] = false;
+            }
+        }
+    }
+
+    /*
+     * RecordAnalogHistory() returns nothing
+     *
+        * @param  The ID of the controller that was just polled.
+        * @param  Pointer to the XINPUT state that was read, or NULL if it is not connected.
+     *
+     * Adds the raw value of each analog axis to its history. The history of a controller that
+     * is not connected is emptied.
+     *
+     * The history may be read by PredictAnalog() on another thread, so each controller's
+     * history is guarded by a version number which is odd while it is being written.
+     * */
+    void Context::RecordAnalogHistory(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        unsigned int version = historyVersions[controllerID].load(std::memory_order_relaxed);
+
+        historyVersions[controllerID].store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (state == NULL)
+        {
+            for (short i = 0; i < 6; ++i) {
+                analogHistory[controllerID][i].count = 0;
+            }
+        }
+        else
+        {
+            short angles[6] = {state->Gamepad.bLeftTrigger, state->Gamepad.bRightTrigger, state->Gamepad.sThumbLX, state->Gamepad.sThumbLY, state->Gamepad.sThumbRX, state->Gamepad.sThumbRY};
+
+            for (short i = 0; i < 6; ++i)
+            {
+                AnalogHistory &history = analogHistory[controllerID][i];
+                unsigned int index = history.count % EZX_ANALOG_HISTORY;
+
+                history.times[index] = status.sampleTime;
+                history.values[index] = angles[i];
+                history.count++;
+            }
+        }
+
+        historyVersions[controllerID].store(version + 2, std::memory_order_release);
+    }
+
+    /*
+     * CalibrateSticks() returns nothing
+     *
+        * @param  The ID of the controller that was just polled.
+        * @param  Pointer to the XINPUT state that was read.
+     *
+     * Adds the state to the controller's stick calibration and corrects its sticks by the
+     * calibrated centers. The calibration may be read by GetCalibration() and PredictAnalog()
+     * on another thread, so it is guarded by the same version number as the analog history.
+     * */
+    void Context::CalibrateSticks(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        unsigned int version = historyVersions[controllerID].load(std::memory_order_relaxed);
+
+        historyVersions[controllerID].store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        calibrations[controllerID].Update(state->Gamepad, deadzones);
+
+        historyVersions[controllerID].store(version + 2, std::memory_order_release);
+
+        calibrations[controllerID].Apply(&state->Gamepad);
+    }
+
+    /*
+     * GetDeadzone() returns short
+     *
+        * @param  The ID of the controller.
+        * @param  The stick axis: 0-3 for LX, LY, RX and RY.
+     *
+     * Returns the calibrated deadzone of the axis while calibration is enabled, and the
+     * configured one otherwise.
+     * */
+    short Context::GetDeadzone(
+        short controllerID,
+        short axis) const
+    {
+        if (calibrating == false) {
+            return deadzones[axis];
+        }
+
+        return calibrations[controllerID].GetDeadzone(axis, deadzones[axis]);
+    }
+
+    /*
+     * DetectConnection() returns nothing
+     *
+        * @param  The ID of the controller to detect a connection for.
+     *
+     * Detects if the controller determined by the passed ID just connected.
+     * If the controller is already connected, or not connected at all,
+     * this function will do nothing.
+     * */
+    inline void Context::DetectConnection(
+        short controllerID)
+    {
+        if (status.controllersDetected[controllerID] == false)
+        {
+            status.controllersDetected[controllerID] = true;
+            PushEvent(Event(controllerID, EZX_CONNECT, controllerID));
+        }
+    }
+
+    /*
+     * DetectDisconnection() returns nothing
+     *
+        * @param  The ID of the controller to detect a disconnection for.
+     *
+     * Detects if the controller determined by the passed ID just disconnected.
+     * If the controller is already disconnected or connected this function will do nothing.
+     * */
+    inline void Context::DetectDisconnection(
+        short controllerID)
+    {
+        if (status.controllersDetected[controllerID])
+        {
+            status.controllersDetected[controllerID] = false;
+            PushEvent(Event(controllerID, EZX_DISCONNECT, controllerID));
+
+            ResetVibrationCache(controllerID);
+        }
+    }
+
+    /*
+     * DetectPressedAnalog()
+     *
+        * @param  The controller ID to detect analog presses for.
+        * @param  The analog ID to detect. Will be an integer between 0-5.
+        * @param  The current angle of the analog.
+     *
+     * */
+    inline void Context::DetectPressedAnalog(
+        short controllerID,
+        short analogAngleID,
+        short angle)
+    {
+        int buttonID = AnalogAngleIDToButtonID(analogAngleID);
+        short previous = status.analogAngles[controllerID][analogAngleID];
+
+        if (previous != angle) {
+            PushEvent(Event(controllerID, EZX_ANALOG, buttonID, angle));
+        }
+
+        status.analogAngles[controllerID][analogAngleID] = angle;
+        PushEvent(Event(controllerID, EZX_PRESS, buttonID, angle), previous == 0);
+    }
+
+    /*
+     * DetectReleasedAnalog()
+     *
+        * @param  The controller ID to detect analog releases for.
+        * @param  The analog ID to detect. Will be an integer between 0-5.
+     *
+     * */
+    inline void Context::DetectReleasedAnalog(
+        short controllerID,
+        short analogAngleID)
+    {
+        int buttonID = AnalogAngleIDToButtonID(analogAngleID);
+
+        if (status.analogAngles[controllerID][analogAngleID]) {
+            PushEvent(Event(controllerID, EZX_RELEASE, buttonID));
+        }
+
+        status.analogAngles[controllerID][analogAngleID] = 0;
+    }
+
+    /*
+     * DetectTriggers() returns nothing
+     *
+        * @param  The ID of the controller to detect the trigger angles for.
+        * @param  Pointer to the XINPUT state object.
+     *
+     * */
+    void Context::DetectTriggers(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        unsigned char angles[2] = EZX_TRIGGER_ANGLES(*state);
+
+        state->Gamepad.wButtons &= EZX_ALL_BUTTONS;
+
+        /*
+         * In digital mode the triggers become two more bits of the button mask, and are
+         * detected by DetectButtons() along with the buttons.
+         * */
+        if (digitalTriggers)
+        {
+            static const WORD bits[2] = {EZX_LTRIGGER_BIT, EZX_RTRIGGER_BIT};
+
+            for (short i = 0; i < 2; i++)
+            {
+                bool held = (status.buttonsDown[controllerID] & bits[i]) != 0;
+
+                if (held ? angles[i] > triggerReleaseThreshold : angles[i] >= triggerPressThreshold) {
+                    state->Gamepad.wButtons |= bits[i];
+                }
+            }
+
+            return;
+        }
+
+        for (short i = 0; i < 2; i++)
+        {
+            if (angles[i] > 0) {
+                DetectPressedAnalog(controllerID, i, angles[i]);
+            } else {
+                DetectReleasedAnalog(controllerID, i);
+            }
+        }
+    }
+
+    /*
+     * DetectAnalogSticks() returns nothing
+     *
+        * @param  The ID of the controller to detect the analog stick angles for.
+        * @param  Pointer to the XINPUT state object.
+     *
+     * */
+    void Context::DetectAnalogSticks(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        short angles[4] = EZX_ANALOG_STICK_ANGLES(*state);
+
+        for (short i = 0; i < 4; i++)
+        {
+            short j = i+2;
+
+            short deadzone = GetDeadzone(controllerID, i);
+
+            if (angles[i] >= deadzone || angles[i] <= -deadzone) {
+                DetectPressedAnalog(controllerID, j, angles[i]);
+            } else {
+                DetectReleasedAnalog(controllerID, j);
+            }
+        }
+    }
+
+    /*
+     * DetectStickDirections() returns nothing
+     *
+        * @param  The ID of the controller to detect the stick directions for.
+        * @param  Pointer to the XINPUT state object.
+     *
+     * Quantizes each stick to one of 4 or 8 sectors and fires an EZX_DIRECTION event only
+     * when the sector changes. A stick that is in a sector stays in it until it is more than
+     * the hysteresis past the edge of the sector, so it doesn't flicker between two directions.
+     * */
+    void Context::DetectStickDirections(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        /*
+         * The sectors in counter-clockwise order, as directions.
+         * */
+        static const short EIGHT_WAY[8] = {EZX_DIR_RIGHT, EZX_DIR_UP_RIGHT, EZX_DIR_UP, EZX_DIR_UP_LEFT, EZX_DIR_LEFT, EZX_DIR_DOWN_LEFT, EZX_DIR_DOWN, EZX_DIR_DOWN_RIGHT};
+        static const short SECTOR_OF[9] = {-1, 0, 2, 4, 6, 1, 3, 5, 7};
+        short angles[4] = EZX_ANALOG_STICK_ANGLES(*state);
+
+        for (short i = 0; i < 2; i++)
+        {
+            short x = angles[i * 2];
+            short y = angles[i * 2 + 1];
+            short &direction = status.stickDirections[controllerID][i];
+            short deadzoneX = GetDeadzone(controllerID, i * 2);
+            short deadzoneY = GetDeadzone(controllerID, i * 2 + 1);
+            short next = EZX_DIR_CENTER;
+
+            /*
+             * A centered stick has no angle, even when the deadzone is zero.
+             * */
+            if ((x != 0 || y != 0) && (x >= deadzoneX || x <= -deadzoneX || y >= deadzoneY || y <= -deadzoneY))
+            {
+                int angle = DiamondAngle(x, y);
+                int quadrant = angle / EZX_DIAMOND_QUADRANT;
+                int offset = angle % EZX_DIAMOND_QUADRANT;
+
+                /*
+                 * Stay in the current sector while within its edges plus the hysteresis.
+                 * Sectors are measured in eighths of a turn; in 4-way mode only even ones are used.
+                 * */
+                if (direction != EZX_DIR_CENTER)
+                {
+                    int sector = SECTOR_OF[direction];
+                    int center = sector * EZX_DIAMOND_QUADRANT / 2;
+                    int halfWidth = directionWays == 4 ? EZX_DIAMOND_QUADRANT / 2
+                                  : (sector % 2 == 0 ? EZX_DIAMOND_22_5 : EZX_DIAMOND_QUADRANT / 2 - EZX_DIAMOND_22_5);
+                    int distance = angle > center ? angle - center : center - angle;
+
+                    if (distance > 2 * EZX_DIAMOND_QUADRANT) {
+                        distance = 4 * EZX_DIAMOND_QUADRANT - distance;
+                    }
+
+                    if (distance <= halfWidth + directionHysteresis) {
+                        continue;
+                    }
+                }
+
+                if (directionWays == 4) {
+                    next = EIGHT_WAY[((quadrant + (offset >= EZX_DIAMOND_QUADRANT / 2)) % 4) * 2];
+                } else if (offset < EZX_DIAMOND_22_5) {
+                    next = EIGHT_WAY[quadrant * 2];
+                } else if (offset <= EZX_DIAMOND_QUADRANT - EZX_DIAMOND_22_5) {
+                    next = EIGHT_WAY[quadrant * 2 + 1];
+                } else {
+                    next = EIGHT_WAY[(quadrant * 2 + 2) % 8];
+                }
+            }
+
+            if (next != direction)
+            {
+                direction = next;
+                PushEvent(Event(controllerID, EZX_DIRECTION, i == 0 ? EZX_LSTICK : EZX_RSTICK, next));
+            }
+        }
+    }
+
+    /*
+     * DetectButtons()
+     *
+        * @param  The controller ID to detect buttons for.
+        * @param  Pointer to the XINPUT state to be used.
+     *
+     * Works on the whole button mask at once: the pressed and released edges are found with
+     * two mask operations, and only the set bits of the masks are visited. Hold and double-tap
+     * timing is only updated on edges; while buttons are held a single comparison decides
+     * whether any long-press or repeat event is due (see DetectHolds()).
+     * */
+    void Context::DetectButtons(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        WORD down = state->Gamepad.wButtons & (EZX_ALL_BUTTONS | EZX_TRIGGER_BITS);
+        WORD previous = status.buttonsDown[controllerID];
+        WORD pressed = down & (WORD)~previous;
+        WORD released = previous & (WORD)~down;
+
+        status.buttonsDown[controllerID] = down;
+
+        for (WORD bits = released; bits; bits &= bits - 1)
+        {
+            WORD button = bits & (WORD)(0 - bits);
+            short index = ButtonIndex(button);
+
+            PushEvent(Event(controllerID, EZX_RELEASE, ButtonBitToID(button)));
+
+            /*
+             * Only a short press can be the first tap of a double tap.
+             * */
+            status.lastRelease[controllerID][index] = (status.longPressed[controllerID] & button) ? 0 : status.sampleTime;
+        }
+
+        status.longPressed[controllerID] &= down;
+
+        /*
+         * Buttons fire PRESS on every poll while held; digital triggers only when pulled.
+         * */
+        for (WORD bits = (down & (WORD)~EZX_TRIGGER_BITS) | (pressed & EZX_TRIGGER_BITS); bits; bits &= bits - 1)
+        {
+            WORD button = bits & (WORD)(0 - bits);
+
+            PushEvent(Event(controllerID, EZX_PRESS, ButtonBitToID(button)), (pressed & button) != 0);
+        }
+
+        for (WORD bits = pressed; bits; bits &= bits - 1)
+        {
+            WORD button = bits & (WORD)(0 - bits);
+            short index = ButtonIndex(button);
+            long long &lastRelease = status.lastRelease[controllerID][index];
+
+            if (lastRelease != 0 && status.sampleTime - lastRelease <= doubleTapTime)
+            {
+                PushEvent(Event(controllerID, EZX_DOUBLE_TAP, ButtonBitToID(button)));
+                lastRelease = 0;
+            }
+
+            status.pressStart[controllerID][index] = status.sampleTime;
+            status.nextHoldEvent[controllerID][index] = 0;
+
+            if (longPressTime > 0)
+            {
+                long long due = status.sampleTime + longPressTime;
+
+                status.nextHoldEvent[controllerID][index] = due;
+
+                if (status.nextHoldDue[controllerID] == 0 || due < status.nextHoldDue[controllerID]) {
+                    status.nextHoldDue[controllerID] = due;
+                }
+            }
+        }
+
+        if (status.nextHoldDue[controllerID] != 0 && status.sampleTime >= status.nextHoldDue[controllerID]) {
+            DetectHolds(controllerID);
+        }
+    }
+
+    /*
+     * DetectHolds() returns nothing
+     *
+        * @param  The controller ID to detect long presses and repeats for.
+     *
+     * Emits EZX_LONG_PRESS for each held button that has reached the long-press time, then
+     * EZX_REPEAT every repeat interval after that, and works out when the next one is due.
+     * A poll that comes late emits at most one repeat per button rather than catching up.
+     * */
+    void Context::DetectHolds(
+        short controllerID)
+    {
+        long long nextDue = 0;
+
+        for (WORD bits = status.buttonsDown[controllerID]; bits; bits &= bits - 1)
+        {
+            WORD button = bits & (WORD)(0 - bits);
+            long long &due = status.nextHoldEvent[controllerID][ButtonIndex(button)];
+
+            if (due == 0) {
+                continue;
+            }
+
+            if (status.sampleTime >= due)
+            {
+                if (status.longPressed[controllerID] & button) {
+                    PushEvent(Event(controllerID, EZX_REPEAT, ButtonBitToID(button)));
+                } else {
+                    PushEvent(Event(controllerID, EZX_LONG_PRESS, ButtonBitToID(button)));
+                    status.longPressed[controllerID] |= button;
+                }
+
+                if (repeatInterval > 0)
+                {
+                    while (due <= status.sampleTime) {
+                        due += repeatInterval;
+                    }
+                }
+                else {
+                    due = 0;
+                    continue;
+                }
+            }
+
+            if (nextDue == 0 || due < nextDue) {
+                nextDue = due;
+            }
+        }
+
+        status.nextHoldDue[controllerID] = nextDue;
+    }
+
+    /*
+     * SchedulePoll() returns nothing
+     *
+        * @param  The ID of the controller that was just polled.
+        * @param  Whether the controller is connected.
+        * @param  The packet number of the state that was just read.
+     *
+     * Decides when the controller should next be polled while adaptive polling is enabled.
+     * A controller whose packet number changed (or that just connected) is active and is
+     * polled at the maximum rate; one that has been idle is polled less often the longer it
+     * stays idle, down to the minimum rate. Disconnected controllers are always polled at the
+     * minimum rate.
+     * */
+    void Context::SchedulePoll(
+        short controllerID,
+        bool connected,
+        DWORD packetNumber)
+    {
+        long long interval = slowPollInterval;
+
+        if (connected)
+        {
+            if (packetNumber != status.packetNumbers[controllerID] || status.controllersDetected[controllerID] == false)
+            {
+                status.packetNumbers[controllerID] = packetNumber;
+                status.lastActivity[controllerID] = status.sampleTime;
+            }
+
+            interval = (status.sampleTime - status.lastActivity[controllerID]) / EZX_IDLE_BACKOFF;
+
+            if (interval < fastPollInterval) {
+                interval = fastPollInterval;
+            } else if (interval > slowPollInterval) {
+                interval = slowPollInterval;
+            }
+        }
+
+        status.nextPoll[controllerID] = status.sampleTime + interval;
+    }
+
+    /*
+     * DetectInput() returns nothing
+     *
+     * Performs an update on the controller detection.
+     * This is the function that builds the events used in the message loop.
+     *
+     * While adaptive polling is enabled only the controllers that are due to be polled
+     * are read; see SetAdaptivePolling().
+     * */
+    void Context::DetectInput()
+    {
+        XINPUT_STATE state;
+        ZeroMemory(&state, sizeof(XINPUT_STATE));
+
+        /*
+         * Claim the active button maps for this pass; see SetButtonMap().
+         * */
+        int maps;
+
+        do {
+            maps = activeMaps.load();
+            readingMaps.store(maps);
+        } while (activeMaps.load() != maps);
+
+        if (readersRunning)
+        {
+            SlotRead reads[4];
+            short    controllerIDs[4];
+            short    count = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(readMutex);
+                long long now = GetTimestamp();
+                bool awaited[4] = {false, false, false, false};
+
+                for (short i = 0; i < 4; ++i)
+                {
+                    if (slotReads[i].phase == READ_IDLE && (slowPollInterval == 0 || now >= status.nextPoll[i]))
+                    {
+                        slotReads[i].phase = READ_REQUESTED;
+                        awaited[i] = slotReads[i].latency <= readTimeout;
+                    }
+                }
+
+                readRequested.notify_all();
+
+                /*
+                 * Wait for the slots that usually answer in time. A slot that is known to be
+                 * slow (or that misses the timeout) is merged in by a later pass, whenever
+                 * its read is done, rather than holding up the others.
+                 * */
+                readCompleted.wait_for(lock, std::chrono::microseconds(readTimeout), [this, &awaited] {
+                    for (short i = 0; i < 4; ++i) {
+                        if (awaited[i] && slotReads[i].phase != READ_DONE) {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                });
+
+                for (short i = 0; i < 4; ++i)
+                {
+                    if (slotReads[i].phase == READ_DONE)
+                    {
+                        reads[count] = slotReads[i];
+                        controllerIDs[count++] = i;
+                        slotReads[i].phase = READ_IDLE;
+                    }
+                }
+            }
+
+            /*
+             * Merge the reads in the order they were sampled, so the events of the pass are
+             * in sample-time order.
+             * */
+            for (short i = 1; i < count; ++i)
+            {
+                for (short j = i; j > 0 && reads[j].sampleTime < reads[j - 1].sampleTime; --j)
+                {
+                    std::swap(reads[j], reads[j - 1]);
+                    std::swap(controllerIDs[j], controllerIDs[j - 1]);
+                }
+            }
+
+            for (short i = 0; i < count; ++i)
+            {
+                status.sampleTime = reads[i].sampleTime;
+                DetectState(controllerIDs[i], reads[i].result, &reads[i].state, reads[i].readStart, maps);
+            }
+        }
+        else
+        {
+            /*
+             * Iterate once for each possible controller.
+             * The "i" variable is used as the controller index.
+             * */
+            for (short i = 0; i < 4; ++i)
+            {
+                long long readStart = GetTimestamp();
+
+                if (slowPollInterval > 0 && readStart < status.nextPoll[i]) {
+                    continue;
+                }
+
+                DWORD result = ReadState(i, &state);
+
+                status.sampleTime = GetTimestamp();
+                DetectState(i, result, &state, readStart, maps);
+            }
+        }
+
+        readingMaps.store(-1);
+
+        if (frameHistory) {
+            frameHistory->Record(frameNumber++, status.packedStates, status.controllersDetected);
+        }
+
+        CommitEvents();
+        ResumeWaiters();
+    }
+
+    /*
+     * DetectState() returns nothing
+     *
+        * @param  The ID of the controller that was read.
+        * @param  The result of the read.
+        * @param  Pointer to the XINPUT state that was read.
+        * @param  The time the read started; status.sampleTime is the time it finished.
+        * @param  The index of the button maps claimed by DetectInput().
+     *
+     * Runs every detection function on one state read by DetectInput().
+     * */
+    void Context::DetectState(
+        short controllerID,
+        DWORD result,
+        PXINPUT_STATE state,
+        long long readStart,
+        int maps)
+    {
+        short i = controllerID;
+
+        metricsCounters.RecordPoll(i, status.sampleTime - readStart);
+
+        if (slowPollInterval > 0) {
+            SchedulePoll(i, result == ERROR_SUCCESS, state->dwPacketNumber);
+        }
+
+        if (result == ERROR_SUCCESS)
+        {
+            buttonMaps[maps][i].Remap(&state->Gamepad);
+
+            if (calibrating) {
+                CalibrateSticks(i, state);
+            }
+
+            status.packedStates[i] = PackedState(state->Gamepad);
+
+            DetectConnection(i);
+            RecordAnalogHistory(i, state);
+
+            if (directionWays) {
+                DetectStickDirections(i, state);
+            } else {
+                DetectAnalogSticks(i, state);
+            }
+
+            DetectTriggers(i, state);
+            DetectButtons(i, state);
+
+            if (slowPollInterval > 0 && status.nextHoldDue[i] != 0 && status.nextHoldDue[i] < status.nextPoll[i]) {
+                status.nextPoll[i] = status.nextHoldDue[i];
+            }
+        }
+        else
+        {
+            if (status.controllersDetected[i]) {
+                RecordAnalogHistory(i, NULL);
+            }
+
+            DetectDisconnection(i);
+        }
+    }
+
+    /*
+     * ReadState() returns DWORD
+     *
+        * @param  The ID of the controller to read.
+        * @param  Pointer to the XINPUT state object to fill in.
+     *
+     * Reads the controller from the backend set with SetBackend(), or from XInput.
+     * */
+    DWORD Context::ReadState(
+        short controllerID,
+        PXINPUT_STATE state)
+    {
+        if (backend) {
+            return backend->GetState(controllerID, state);
+        }
+
+        return XInputGetState(controllerID, state);
+    }
+
+    /*
+     * ReaderLoop() returns nothing
+     *
+        * @param  The ID of the controller slot the thread reads.
+     *
+     * The body of a slot reader thread: reads the slot whenever DetectInput() asks for it.
+     * */
+    void Context::ReaderLoop(
+        short controllerID)
+    {
+        SlotRead &slot = slotReads[controllerID];
+        std::unique_lock<std::mutex> lock(readMutex);
+
+        while (true)
+        {
+            readRequested.wait(lock, [this, &slot] { return slot.phase == READ_REQUESTED || readersRunning == false; });
+
+            if (readersRunning == false) {
+                return;
+            }
+
+            slot.phase = READ_BUSY;
+            lock.unlock();
+
+            XINPUT_STATE state;
+            ZeroMemory(&state, sizeof(XINPUT_STATE));
+
+            long long readStart = GetTimestamp();
+            DWORD result = ReadState(controllerID, &state);
+            long long sampleTime = GetTimestamp();
+
+            lock.lock();
+
+            slot.state = state;
+            slot.result = result;
+            slot.readStart = readStart;
+            slot.sampleTime = sampleTime;
+            slot.latency = sampleTime - readStart;
+            slot.phase = READ_DONE;
+
+            readCompleted.notify_all();
+        }
+    }
+
+    /*
+     * StopReaders() returns nothing
+     *
+     * Stops the slot reader threads started by SetParallelPolling() and waits for them
+     * to finish. A read that is in progress is completed first.
+     * */
+    void Context::StopReaders()
+    {
+        if (readersRunning == false) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(readMutex);
+            readersRunning = false;
+        }
+
+        readRequested.notify_all();
+
+        for (short i = 0; i < 4; ++i) {
+            readerThreads[i].join();
+        }
+    }
+
+    /*
+     * FlushEvents() returns nothing
+     * Removes all current Event objects in the event queue.
+     * */
+    void Context::FlushEvents()
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        std::deque<QueuedEvent>().swap(eventQueue);
+        queuedEvents.store(0, std::memory_order_release);
+    }
+
+    /*
+     * GetEvent() returns bool
+     *
+         * @param  Pointer to the Event object to provide data to.
+     *
+     * The function which controls the message loop.
+     * Will only ever return true if there are events to be handled.
+     * */
+    bool Context::GetEvent(
+        Event *event)
+    {
+        if (event == NULL || queuedEvents.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+
+            if (eventQueue.empty()) {
+                return false;
+            }
+
+            *event = eventQueue.front().event;
+            eventQueue.pop_front();
+            queuedEvents.store(eventQueue.size(), std::memory_order_release);
+        }
+
+        metricsCounters.RecordDwell(GetTimestamp() - event->timestamp);
+        return true;
+    }
+
+    /*
+     * WaitForEvent() returns bool
+     *
+        * @param  Pointer to the Event object to provide data to.
+        * @param  The longest time to wait in milliseconds, or EZX_WAIT_INFINITE.
+     *
+     * Like GetEvent(), but waits for an event to be detected if the queue is empty.
+     * The calling thread first checks the queue the number of times set by SetWaitSpinCount(),
+     * and then sleeps until the polling thread adds events to the queue.
+     *
+     * If the polling thread is not running, input is detected on the calling thread instead,
+     * waiting between polls for new input or for the polling delay, whichever comes first.
+     *
+     * Will return false if no event was detected before the timeout.
+     * */
+    bool Context::WaitForEvent(
+        Event *event,
+        unsigned int timeout)
+    {
+        if (event == NULL) {
+            return false;
+        }
+
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+        for (unsigned int i = 0; i < spinCount; ++i)
+        {
+            if (GetEvent(event)) {
+                return true;
+            }
+
+            std::this_thread::yield();
+        }
+
+        while (true)
+        {
+            if (polling.load() == false)
+            {
+                if (GetEvent(event)) {
+                    return true;
+                }
+
+                DetectInput();
+
+                if (GetEvent(event)) {
+                    return true;
+                }
+
+                long long delay = GetPollingDelay();
+
+                if (timeout != EZX_WAIT_INFINITE)
+                {
+                    long long remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count();
+
+                    if (remaining <= 0) {
+                        return false;
+                    }
+
+                    if (delay < 0 || delay > remaining) {
+                        delay = remaining;
+                    }
+                }
+
+                WaitForPoll(delay);
+                continue;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                bool ready;
+
+                ++waitingConsumers;
+
+                if (timeout == EZX_WAIT_INFINITE) {
+                    queueCondition.wait(lock, [this] { return eventQueue.empty() == false || polling.load() == false; });
+                    ready = true;
+                } else {
+                    ready = queueCondition.wait_until(lock, deadline, [this] { return eventQueue.empty() == false || polling.load() == false; });
+                }
+
+                --waitingConsumers;
+
+                if (eventQueue.empty() == false)
+                {
+                    *event = eventQueue.front().event;
+                    eventQueue.pop_front();
+                    queuedEvents.store(eventQueue.size(), std::memory_order_release);
+                }
+                else if (ready) {
+                    continue;
+                }
+                else {
+                    return false;
+                }
+            }
+
+            metricsCounters.RecordDwell(GetTimestamp() - event->timestamp);
+            return true;
+        }
+    }
+
+    /*
+     * SetQueueLimit() returns nothing
+     *
+        * @param  The most events the queue holds, or 0 for no limit (the default).
+        * @param  What to do when the queue is full: EZX_OVERFLOW_COALESCE, EZX_OVERFLOW_DROP_OLDEST
+        *         or EZX_OVERFLOW_DROP_NEWEST.
+     *
+     * Keeps the memory of the queue capped while nothing consumes events, e.g. during a loading
+     * screen. ANALOG and REPEAT events, and PRESS events that a later PRESS of the same hold
+     * supersedes, are shed first, then gestures; CONNECT and DISCONNECT events, the first PRESS
+     * of each hold and the newest RELEASE of each input are always kept, so a consumer never
+     * misses a change of state (see ShedEvents()).
+     * What was shed is counted in the droppedEvents, droppedByType and coalescedEvents metrics.
+     * */
+    void Context::SetQueueLimit(
+        std::size_t limit,
+        int policy)
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        queueLimit = limit;
+        overflowPolicy = policy;
+    }
+
+    /*
+     * AddWaiter() returns bool
+     *
+        * @param  The waiter to resume when a matching event is detected.
+     *
+     * The waiter is resumed once, by the thread that calls DetectInput() (the polling thread
+     * while StartPolling() is active), at the end of the pass that detects the first matching
+     * event. Matching events are still added to the event queue as usual.
+     * Waiters are kept in intrusive lists by event type and controller, so thousands of them
+     * cost no memory allocations and nothing at all while no matching input arrives.
+     *
+     * The waiter must stay alive until it is resumed or removed with RemoveWaiter().
+     * Will return false if the waiter is NULL, already waiting, or its filter is invalid
+     * (see EventFilter::IsValid()).
+     * */
+    bool Context::AddWaiter(
+        EventWaiter *waiter)
+    {
+        if (waiter == NULL) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(waiterMutex);
+        EventWaiter **list = GetWaiterList(waiter->filter);
+
+        if (list == NULL || waiter->waiting) {
+            return false;
+        }
+
+        waiter->previous = NULL;
+        waiter->next = *list;
+
+        if (*list) {
+            (*list)->previous = waiter;
+        }
+
+        *list = waiter;
+        waiter->waiting = true;
+        waiterCount.fetch_add(1);
+        return true;
+    }
+
+    /*
+     * RemoveWaiter() returns bool
+     *
+        * @param  The waiter to stop waiting.
+     *
+     * Will return false if the waiter was not waiting, e.g. because it was already resumed.
+     * Waiters that are destroyed from another thread than the one detecting input must be
+     * removed before they are destroyed, and must not be destroyed while being resumed.
+     * */
+    bool Context::RemoveWaiter(
+        EventWaiter *waiter)
+    {
+        if (waiter == NULL) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(waiterMutex);
+
+        if (waiter->waiting == false) {
+            return false;
+        }
+
+        UnlinkWaiter(waiter);
+        return true;
+    }
+
+    /*
+     * SetWaitSpinCount() returns nothing
+     *
+        * @param  The number of times to check the queue before sleeping.
+     *
+     * Sets how many times WaitForEvent() checks the queue (yielding the thread between checks)
+     * before it goes to sleep. Spinning trades CPU time for a slightly faster wake up when
+     * events are expected very soon. Defaults to zero.
+     * */
+    void Context::SetWaitSpinCount(
+        unsigned int spinCount)
+    {
+        this->spinCount = spinCount;
+    }
+
+    /*
+     * StartPolling() returns bool
+     *
+        * @param  The number of polls per second, used while adaptive polling is disabled.
+     *
+     * Starts a thread that calls DetectInput() at the passed rate (or at the rate chosen by
+     * adaptive polling, if it is enabled) and wakes WaitForEvent() whenever events are detected.
+     * The settings of the context must not be changed while the thread is running.
+     *
+     * Will return false if the thread is already running.
+     * */
+    bool Context::StartPolling(
+        unsigned int rate)
+    {
+        if (polling.load()) {
+            return false;
+        }
+
+        pollRate = rate > 0 ? rate : EZX_POLL_RATE;
+        polling.store(true);
+        pollingThread = std::thread(&Context::PollingLoop, this);
+        pollingWaiter.Wake();
+
+        return true;
+    }
+
+    /*
+     * StopPolling() returns nothing
+     *
+     * Stops the polling thread started by StartPolling() and waits for it to finish.
+     * Consumers blocked in WaitForEvent() go back to detecting input themselves.
+     * */
+    void Context::StopPolling()
+    {
+        if (polling.exchange(false) == false) {
+            return;
+        }
+
+        pollingWaiter.Wake();
+        pollingThread.join();
+
+        /*
+         * Waiters check the polling flag while holding the queue mutex; taking it here makes
+         * sure none of them can miss the notification between checking the flag and sleeping.
+         * */
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+        }
+
+        queueCondition.notify_all();
+    }
+
+    /*
+     * GetPollingDelay() returns long long
+     *
+     * Returns how many microseconds to wait before the next call to DetectInput(), or -1
+     * to wait until new input arrives. The latter is only possible when the context reads the
+     * platform's own input (no backend is set), the platform can signal new input, and nothing
+     * is held, since held input raises events on every poll.
+     *
+     * With adaptive polling the schedule of GetPollDelay() is always followed; where the
+     * platform signals new input, the wait still ends early when input arrives and the
+     * controllers that had input are polled right away (see WaitForPoll()).
+     * */
+    long long Context::GetPollingDelay() const
+    {
+        if (slowPollInterval > 0) {
+            return GetPollDelay();
+        }
+
+        if (backend == NULL && InputWaiter::IsEventDriven() && IsInputHeld() == false) {
+            return -1;
+        }
+
+        return 1000000 / pollRate;
+    }
+
+    /*
+     * PollingLoop() returns nothing
+     *
+     * The body of the polling thread.
+     * */
+    void Context::PollingLoop()
+    {
+        while (polling.load())
+        {
+            DetectInput();
+            WaitForPoll(GetPollingDelay());
+        }
+    }
+
+    /*
+     * WaitForPoll() returns nothing
+     *
+        * @param  The longest time to wait in microseconds, or a negative number to wait until input arrives.
+     *
+     * Sleeps until the next poll. With adaptive polling, controllers that the platform
+     * reported new input for are made due at once, so that the next DetectInput() reads the
+     * input instead of skipping them until their scheduled poll. A context with a backend
+     * (see SetBackend()) only sleeps; the platform's input is not what it reads.
+     * */
+    void Context::WaitForPoll(
+        long long delay)
+    {
+        unsigned int slots = pollingWaiter.Wait(delay, backend == NULL);
+
+        if (slowPollInterval > 0)
+        {
+            for (short i = 0; i < 4; ++i)
+            {
+                if (slots & (1u << i)) {
+                    status.nextPoll[i] = 0;
+                }
+            }
+        }
+    }
+
+    /*
+     * IsInputHeld() returns bool
+     *
+     * Returns true if any button, trigger or analog stick of a connected controller is held.
+     * */
+    bool Context::IsInputHeld() const
+    {
+        for (short i = 0; i < 4; i++)
+        {
+            if (status.controllersDetected[i] == false) {
+                continue;
+            }
+
+            if (status.buttonsDown[i]) {
+                return true;
+            }
+
+            for (short j = 0; j < 6; j++) {
+                if (status.analogAngles[i][j]) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /*
+     * GetMetrics() returns bool
+     *
+        * @param  The Metrics object to store the snapshot in.
+     *
+     * Copies the current value of every pipeline counter into the passed object.
+     * Will return false if a NULL pointer is given.
+     * */
+    bool Context::GetMetrics(
+        Metrics *metrics) const
+    {
+        if (metrics == NULL) {
+            return false;
+        }
+
+        metricsCounters.Snapshot(metrics);
+        return true;
+    }
+
+    /*
+     * ResetMetrics() returns nothing
+     * Sets every pipeline counter back to zero.
+     * */
+    void Context::ResetMetrics()
+    {
+        metricsCounters.Reset();
+    }
+
+    /*
+     * SetDeadzones() returns nothing
+     *
+        * @param  The deadzone of the left analog stick, between 0 and 32767.
+        * @param  The deadzone of the right analog stick, between 0 and 32767.
+     *
+     * Analog stick values within the deadzone are treated as if the stick was released.
+     * Defaults to the values recommended by XInput.
+     * */
+    void Context::SetDeadzones(
+        short leftThumbDeadzone,
+        short rightThumbDeadzone)
+    {
+        deadzones[0] = leftThumbDeadzone;
+        deadzones[1] = leftThumbDeadzone;
+        deadzones[2] = rightThumbDeadzone;
+        deadzones[3] = rightThumbDeadzone;
+    }
+
+    /*
+     * SetStickCalibration() returns nothing
+     *
+        * @param  Whether the sticks are calibrated while input is detected.
+     *
+     * While enabled, each controller learns where its sticks rest and how much they jitter
+     * while resting. The learned centers are subtracted from the sticks and the deadzones
+     * are derived from the jitter (see StickCalibration), so a drifting stick stops sending
+     * events without raising the deadzone of every controller. The configured deadzones are
+     * used until an axis has been at rest for EZX_CALIBRATION_SAMPLES polls.
+     * Calibrations are kept when it is disabled, and used again when it is re-enabled.
+     * */
+    void Context::SetStickCalibration(
+        bool enabled)
+    {
+        calibrating = enabled;
+    }
+
+    /*
+     * GetCalibration() returns bool
+     *
+        * @param  The ID of the controller.
+        * @param  The StickCalibration object to copy the controller's calibration into.
+     *
+     * May be called from any thread, e.g. to Export() the calibration when the game exits.
+     * Will return false if the controller ID is invalid or a NULL pointer is given.
+     * */
+    bool Context::GetCalibration(
+        short controllerID,
+        StickCalibration *calibration) const
+    {
+        if (controllerID < 0 || controllerID > 3 || calibration == NULL) {
+            return false;
+        }
+
+        unsigned int version;
+
+        do
+        {
+            version = historyVersions[controllerID].load(std::memory_order_acquire);
+            *calibration = calibrations[controllerID];
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while ((version & 1) || version != historyVersions[controllerID].load(std::memory_order_relaxed));
+
+        return true;
+    }
+
+    /*
+     * SetCalibration() returns bool
+     *
+        * @param  The ID of the controller.
+        * @param  The calibration to use, e.g. one restored with StickCalibration::Import().
+     *
+     * Must be called from the thread that detects input (or while it is stopped).
+     * Will return false if the controller ID is invalid.
+     * */
+    bool Context::SetCalibration(
+        short controllerID,
+        const StickCalibration &calibration)
+    {
+        if (controllerID < 0 || controllerID > 3) {
+            return false;
+        }
+
+        unsigned int version = historyVersions[controllerID].load(std::memory_order_relaxed);
+
+        historyVersions[controllerID].store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        calibrations[controllerID] = calibration;
+
+        historyVersions[controllerID].store(version + 2, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * SetBackend() returns nothing
+     *
+        * @param  The backend to read controllers from, or NULL to use XInput.
+     *
+     * The backend is not owned by the context, and must stay alive while it is in use.
+     * A backend cannot wake a waiting thread when it has new input, so the polling thread and
+     * WaitForEvent() poll it at the polling rate (or the adaptive schedule) even when nothing
+     * is held.
+     * */
+    void Context::SetBackend(
+        InputBackend *backend)
+    {
+        this->backend = backend;
+    }
+
+    /*
+     * SetParallelPolling() returns nothing
+     *
+        * @param  Whether each controller slot is read by its own thread.
+        * @param  The longest time (in microseconds) DetectInput() waits for the reads.
+     *
+     * Normally DetectInput() reads the four slots one after another, so a slot that is slow
+     * to read (XInput can take a long time to report an empty slot) delays the sampling of
+     * every controller after it. In parallel mode every slot is read at the same time by its
+     * own thread, and DetectInput() only waits for the slots that are usually fast. A read
+     * that takes longer than the timeout is merged into a later pass once it is done, so the
+     * latency of each controller doesn't depend on the others.
+     * */
+    void Context::SetParallelPolling(
+        bool enabled,
+        unsigned int readTimeout)
+    {
+        this->readTimeout = readTimeout;
+
+        if (enabled == readersRunning) {
+            return;
+        }
+
+        if (enabled == false) {
+            StopReaders();
+            return;
+        }
+
+        for (short i = 0; i < 4; ++i)
+        {
+            ZeroMemory(&slotReads[i].state, sizeof(XINPUT_STATE));
+            slotReads[i].result = ERROR_DEVICE_NOT_CONNECTED;
+            slotReads[i].readStart = 0;
+            slotReads[i].sampleTime = 0;
+            slotReads[i].latency = 0;
+            slotReads[i].phase = READ_IDLE;
+        }
+
+        readersRunning = true;
+
+        for (short i = 0; i < 4; ++i) {
+            readerThreads[i] = std::thread(&Context::ReaderLoop, this, i);
+        }
+    }
+
+    /*
+     * SetStickDirections() returns nothing
+     *
+        * @param  4 or 8 to detect the sticks as that many directions, or 0 to detect them as axes.
+        * @param  How far (in degrees) a stick has to move past the edge of its sector before
+        *         its direction changes.
+     *
+     * While directions are detected, each stick fires an EZX_DIRECTION event (with EZX_LSTICK
+     * or EZX_RSTICK as the ID, and the direction as the angle) only when its direction changes,
+     * instead of ANALOG and PRESS events for each axis on every poll.
+     * The sticks' deadzones decide when a stick is centered (see SetDeadzones()).
+     * */
+    void Context::SetStickDirections(
+        int ways,
+        unsigned int hysteresis)
+    {
+        directionWays = (ways == 4 || ways == 8) ? ways : 0;
+        directionHysteresis = (int)(hysteresis > 45 ? 45 : hysteresis) * EZX_DIAMOND_QUADRANT / 90;
+
+        /*
+         * Whichever mode is left, start the other one from scratch.
+         * */
+        for (short i = 0; i < 4; ++i)
+        {
+            status.stickDirections[i][0] = EZX_DIR_CENTER;
+            status.stickDirections[i][1] = EZX_DIR_CENTER;
+
+            for (short j = 2; j < 6; ++j) {
+                status.analogAngles[i][j] = 0;
+            }
+        }
+    }
+
+    /*
+     * SetDigitalTriggers() returns nothing
+     *
+        * @param  Whether the triggers are detected as buttons.
+        * @param  The value at which a released trigger becomes pressed.
+        * @param  The value at or below which a pressed trigger becomes released.
+     *
+     * In digital mode a trigger fires one PRESS when it is pulled past the press threshold
+     * and one RELEASE when it falls back to the release threshold (with EZX_LTRIGGER or
+     * EZX_RTRIGGER as the ID), instead of ANALOG and PRESS events on every poll. Long presses,
+     * repeats and double taps are detected for the triggers like for any other button.
+     * The release threshold is clamped to the press threshold.
+     * */
+    void Context::SetDigitalTriggers(
+        bool enabled,
+        BYTE pressThreshold,
+        BYTE releaseThreshold)
+    {
+        digitalTriggers = enabled;
+        triggerPressThreshold = pressThreshold;
+        triggerReleaseThreshold = releaseThreshold < pressThreshold ? releaseThreshold : pressThreshold;
+
+        /*
+         * Whichever mode is left, start the other one from scratch.
+         * */
+        for (short i = 0; i < 4; ++i)
+        {
+            status.buttonsDown[i] &= (WORD)~EZX_TRIGGER_BITS;
+            status.analogAngles[i][0] = 0;
+            status.analogAngles[i][1] = 0;
+        }
+    }
+
+    /*
+     * SetButtonMap() returns nothing
+     *
+        * @param  The ID of the controller, or -1 for all four.
+        * @param  The layout to apply to the controller's input.
+     *
+     * Every state read from the controller is remapped before detection, so the events,
+     * the frame history and PredictAnalog() all use the remapped IDs.
+     *
+     * May be called from any thread while input is being detected. The maps are double
+     * buffered: the new layout is written into the buffer that DetectInput() is not using
+     * and then made active with a single atomic store, so detection never waits and a pass
+     * never sees half of a layout. The calling thread waits at most for the end of one pass.
+     * */
+    void Context::SetButtonMap(
+        short controllerID,
+        const ButtonMap &map)
+    {
+        if (controllerID < -1 || controllerID > 3) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mapMutex);
+
+        int active = activeMaps.load();
+        int next = 1 - active;
+
+        while (readingMaps.load() == next) {
+            std::this_thread::yield();
+        }
+
+        for (short i = 0; i < 4; ++i) {
+            buttonMaps[next][i] = (controllerID == -1 || controllerID == i) ? map : buttonMaps[active][i];
+        }
+
+        activeMaps.store(next);
+    }
+
+    /*
+     * GetButtonMap() returns bool
+     *
+        * @param  The ID of the controller.
+        * @param  The ButtonMap object to copy the controller's layout into.
+     *
+     * Will return false if the controller ID is invalid or a NULL pointer is given.
+     * */
+    bool Context::GetButtonMap(
+        short controllerID,
+        ButtonMap *map) const
+    {
+        if (controllerID < 0 || controllerID > 3 || map == NULL) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mapMutex);
+
+        *map = buttonMaps[activeMaps.load()][controllerID];
+        return true;
+    }
+
+    /*
+     * SetHoldTiming() returns nothing
+     *
+        * @param  How long a button is held before EZX_LONG_PRESS, in milliseconds.
+        * @param  How often EZX_REPEAT follows while the button stays held, in milliseconds.
+        * @param  The longest gap between two taps that makes an EZX_DOUBLE_TAP, in milliseconds.
+     *
+     * Passing zero disables the respective event. Defaults to EZX_LONG_PRESS_TIME,
+     * EZX_REPEAT_INTERVAL and EZX_DOUBLE_TAP_TIME.
+     * */
+    void Context::SetHoldTiming(
+        unsigned int longPressTime,
+        unsigned int repeatInterval,
+        unsigned int doubleTapTime)
+    {
+        this->longPressTime = longPressTime * 1000LL;
+        this->repeatInterval = repeatInterval * 1000LL;
+        this->doubleTapTime = doubleTapTime * 1000LL;
+    }
+
+    /*
+     * GetHoldDuration() returns long long
+     *
+        * @param  The ID of the controller.
+        * @param  The ID of the button, e.g. EZX_A.
+     *
+     * Returns how long (in microseconds) the button has been held as of the newest poll,
+     * or 0 if it is not held.
+     * */
+    long long Context::GetHoldDuration(
+        short controllerID,
+        int button) const
+    {
+        WORD bit = ButtonIDToBit(button);
+
+        if (controllerID < 0 || controllerID > 3 || bit == 0) {
+            return 0;
+        }
+
+        if ((status.buttonsDown[controllerID] & bit) == 0) {
+            return 0;
+        }
+
+        return status.sampleTime - status.pressStart[controllerID][ButtonIndex(bit)];
+    }
+
+    /*
+     * SetAdaptivePolling() returns nothing
+     *
+        * @param  The lowest rate to poll a controller at, in polls per second.
+        * @param  The highest rate to poll a controller at, in polls per second.
+     *
+     * Enables adaptive polling: each controller is polled at the maximum rate while its
+     * inputs are changing and progressively less often while it is idle, down to the minimum
+     * rate. DetectInput() then skips controllers that are not due, and GetPollDelay() tells
+     * the caller how long it can wait before calling DetectInput() again.
+     *
+     * Passing zero for either rate disables adaptive polling, so every call to DetectInput()
+     * polls every controller (the default).
+     * */
+    void Context::SetAdaptivePolling(
+        unsigned int minimumRate,
+        unsigned int maximumRate)
+    {
+        if (minimumRate == 0 || maximumRate == 0)
+        {
+            fastPollInterval = 0;
+            slowPollInterval = 0;
+        }
+        else
+        {
+            if (minimumRate > maximumRate) {
+                std::swap(minimumRate, maximumRate);
+            }
+
+            fastPollInterval = 1000000 / maximumRate;
+            slowPollInterval = 1000000 / minimumRate;
+        }
+
+        for (short i = 0; i < 4; ++i) {
+            status.nextPoll[i] = 0;
+        }
+    }
+
+    /*
+     * GetPollDelay() returns long long
+     *
+     * Returns how many microseconds remain until the next controller is due to be polled,
+     * or zero if one is already due (or adaptive polling is disabled).
+     * */
+    long long Context::GetPollDelay() const
+    {
+        if (slowPollInterval == 0) {
+            return 0;
+        }
+
+        long long next = status.nextPoll[0];
+
+        for (short i = 1; i < 4; ++i)
+        {
+            if (status.nextPoll[i] < next) {
+                next = status.nextPoll[i];
+            }
+        }
+
+        long long delay = next - GetTimestamp();
+        return delay > 0 ? delay : 0;
+    }
+
+    /*
+     * PredictAnalog() returns bool
+     *
+        * @param  The ID of the controller.
+        * @param  The ID of the analog, e.g. EZX_LTHUMB_X or EZX_RTRIGGER.
+        * @param  The time to predict the value at (see ezx::GetTimestamp()).
+        * @param  EZX_PREDICT_LINEAR or EZX_PREDICT_FILTERED.
+        * @param  Pointer to store the predicted value in.
+     *
+     * Estimates the value of an analog at any point in time from the samples taken by the
+     * most recent calls to DetectInput(), so that e.g. a renderer can sample the sticks at
+     * present time without polling the device more often.
+     *
+     * Times within the history are interpolated between the two surrounding samples.
+     * Times after the newest sample are extrapolated (by at most EZX_PREDICT_HORIZON):
+     * EZX_PREDICT_LINEAR continues the line through the two newest samples, and
+     * EZX_PREDICT_FILTERED continues the least-squares line through every sample in the history,
+     * which responds a little later but is far less sensitive to noise.
+     *
+     * Predicted stick values inside the deadzone are returned as zero, like the values of
+     * analog events. May be called on a different thread than the one detecting input.
+     * Will return false if the controller is not connected or the analog ID is not valid.
+     * */
+    bool Context::PredictAnalog(
+        short controllerID,
+        int which,
+        long long timestamp,
+        int mode,
+        short *value) const
+    {
+        short analogAngleID = ButtonIDToAnalogAngleID(which);
+
+        if (value == NULL || analogAngleID < 0 || controllerID < 0 || controllerID > 3) {
+            return false;
+        }
+
+        AnalogHistory history;
+        short deadzone = 0;
+        unsigned int version;
+
+        do
+        {
+            version = historyVersions[controllerID].load(std::memory_order_acquire);
+            history = analogHistory[controllerID][analogAngleID];
+
+            if (analogAngleID >= 2) {
+                deadzone = GetDeadzone(controllerID, analogAngleID - 2);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while ((version & 1) || version != historyVersions[controllerID].load(std::memory_order_relaxed));
+
+        if (history.count == 0) {
+            return false;
+        }
+
+        unsigned int samples = history.count < EZX_ANALOG_HISTORY ? history.count : EZX_ANALOG_HISTORY;
+        unsigned int newest = (history.count - 1) % EZX_ANALOG_HISTORY;
+        unsigned int oldest = (history.count - samples) % EZX_ANALOG_HISTORY;
+        double predicted = history.values[newest];
+
+        if (timestamp <= history.times[oldest]) {
+            predicted = history.values[oldest];
+        }
+        else if (timestamp < history.times[newest])
+        {
+            /*
+             * Walk back from the newest sample to the two samples surrounding the timestamp.
+             * */
+            for (unsigned int i = 1; i < samples; ++i)
+            {
+                unsigned int later = (history.count - i) % EZX_ANALOG_HISTORY;
+                unsigned int earlier = (history.count - i - 1) % EZX_ANALOG_HISTORY;
+
+                if (history.times[earlier] <= timestamp)
+                {
+                    double span = (double)(history.times[later] - history.times[earlier]);
+                    double weight = span > 0.0 ? (double)(timestamp - history.times[earlier]) / span : 1.0;
+
+                    predicted = history.values[earlier] + weight * (history.values[later] - history.values[earlier]);
+                    break;
+                }
+            }
+        }
+        else if (samples > 1)
+        {
+            long long ahead = timestamp - history.times[newest];
+
+            if (ahead > EZX_PREDICT_HORIZON) {
+                ahead = EZX_PREDICT_HORIZON;
+            }
+
+            if (mode == EZX_PREDICT_FILTERED)
+            {
+                /*
+                 * Fit a line through every sample, with times relative to the newest sample.
+                 * */
+                double meanTime = 0.0;
+                double meanValue = 0.0;
+                double covariance = 0.0;
+                double variance = 0.0;
+
+                for (unsigned int i = 0; i < samples; ++i)
+                {
+                    meanTime += (double)(history.times[i] - history.times[newest]);
+                    meanValue += history.values[i];
+                }
+
+                meanTime /= samples;
+                meanValue /= samples;
+
+                for (unsigned int i = 0; i < samples; ++i)
+                {
+                    double time = (double)(history.times[i] - history.times[newest]) - meanTime;
+
+                    covariance += time * (history.values[i] - meanValue);
+                    variance += time * time;
+                }
+
+                predicted = meanValue + (variance > 0.0 ? covariance / variance : 0.0) * ((double)ahead - meanTime);
+            }
+            else
+            {
+                unsigned int previous = (history.count - 2) % EZX_ANALOG_HISTORY;
+                long long span = history.times[newest] - history.times[previous];
+
+                if (span > 0) {
+                    predicted += (double)(history.values[newest] - history.values[previous]) * ahead / span;
+                }
+            }
+        }
+
+        double minimum = analogAngleID < 2 ? 0.0 : -32768.0;
+        double maximum = analogAngleID < 2 ? 255.0 : 32767.0;
+
+        if (predicted < minimum) {
+            predicted = minimum;
+        } else if (predicted > maximum) {
+            predicted = maximum;
+        }
+
+        if (analogAngleID >= 2 && predicted < deadzone && predicted > -deadzone) {
+            predicted = 0.0;
+        }
+
+        *value = (short)(predicted < 0.0 ? predicted - 0.5 : predicted + 0.5);
+        return true;
+    }
+
+    /*
+     * SetFrameHistory() returns nothing
+     *
+        * @param  The history to record frames in, or NULL to stop recording.
+     *
+     * While a history is set, each call to DetectInput() records the state of every controller
+     * in it as one frame, numbered by the frame counter (see SetFrameNumber()), and then
+     * advances the counter. The history must outlive its use by this context.
+     * */
+    void Context::SetFrameHistory(
+        FrameHistory *history)
+    {
+        frameHistory = history;
+    }
+
+    /*
+     * SetFrameNumber() returns nothing
+     *
+        * @param  The number of the frame recorded by the next call to DetectInput().
+     *
+     * */
+    void Context::SetFrameNumber(
+        unsigned long frame)
+    {
+        frameNumber = frame;
+    }
+
+    /*
+     * GetFrameNumber() returns unsigned long
+     *
+     * Returns the number of the frame that will be recorded by the next call to DetectInput().
+     * */
+    unsigned long Context::GetFrameNumber() const
+    {
+        return frameNumber;
+    }
+
+    /*
+     * SetEventBus() returns nothing
+     *
+        * @param  The bus to publish events to, or NULL to go back to using the event queue.
+     *
+     * While a bus is set every detected event is published to it once, for any number of
+     * EventSubscriber objects to read, instead of being added to the event queue.
+     * The bus must outlive its use by this context.
+     * */
+    void Context::SetEventBus(
+        EventBus *bus)
+    {
+        eventBus = bus;
+    }
+
+    /*
+     * GetDefaultContext() returns Context&
+     *
+     * Returns the context used by the free functions, e.g. ezx::DetectInput().
+     * The context is created the first time it is needed.
+     * */
+    Context& GetDefaultContext()
+    {
+        static Context defaultContext;
+        return defaultContext;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,797 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "evdev.hpp"
+
+#ifndef _WIN32
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#define EZX_INPUT_DIRECTORY "/dev/input"
+#define EZX_NOTIFY_SLOT     0xFF
+#define EZX_TEST_BIT(bits, bit) (((bits)[(bit) / 8] >> ((bit) % 8)) & 1)
+
+namespace ezx
+{
+    /*
+     * ScaleStick() returns SHORT
+     *
+        * @param  The raw axis value.
+        * @param  The range reported by the device.
+        * @param  True if the axis points down where XInput points up.
+     * */
+    static inline SHORT ScaleStick(
+        int value,
+        int minimum,
+        int maximum,
+        bool inverted)
+    {
+        if (maximum <= minimum) {
+            return 0;
+        }
+
+        long long scaled = ((long long)(value - minimum) * 65535) / (maximum - minimum) - 32768;
+
+        if (inverted) {
+            scaled = -scaled - 1;
+        }
+
+        return (SHORT)(scaled < -32768 ? -32768 : (scaled > 32767 ? 32767 : scaled));
+    }
+
+    /*
+     * ScaleTrigger() returns BYTE
+     *
+        * @param  The raw axis value.
+        * @param  The range reported by the device.
+     * */
+    static inline BYTE ScaleTrigger(
+        int value,
+        int minimum,
+        int maximum)
+    {
+        if (maximum <= minimum) {
+            return 0;
+        }
+
+        long long scaled = ((long long)(value - minimum) * 255) / (maximum - minimum);
+
+        return (BYTE)(scaled < 0 ? 0 : (scaled > 255 ? 255 : scaled));
+    }
+
+    /*
+     * KeyCodeToButton() returns WORD
+     *
+        * @param  The evdev key code.
+     *
+     * Returns the XInput button mask for the key, or 0 if the key is not a button.
+     * */
+    static inline WORD KeyCodeToButton(
+        unsigned short code)
+    {
+        switch (code)
+        {
+        case BTN_A:          return XINPUT_GAMEPAD_A;
+        case BTN_B:          return XINPUT_GAMEPAD_B;
+        case BTN_X:          return XINPUT_GAMEPAD_X;
+        case BTN_Y:          return XINPUT_GAMEPAD_Y;
+        case BTN_TL:         return XINPUT_GAMEPAD_LEFT_SHOULDER;
+        case BTN_TR:         return XINPUT_GAMEPAD_RIGHT_SHOULDER;
+        case BTN_SELECT:     return XINPUT_GAMEPAD_BACK;
+        case BTN_START:      return XINPUT_GAMEPAD_START;
+        case BTN_THUMBL:     return XINPUT_GAMEPAD_LEFT_THUMB;
+        case BTN_THUMBR:     return XINPUT_GAMEPAD_RIGHT_THUMB;
+        case BTN_DPAD_UP:    return XINPUT_GAMEPAD_DPAD_UP;
+        case BTN_DPAD_DOWN:  return XINPUT_GAMEPAD_DPAD_DOWN;
+        case BTN_DPAD_LEFT:  return XINPUT_GAMEPAD_DPAD_LEFT;
+        case BTN_DPAD_RIGHT: return XINPUT_GAMEPAD_DPAD_RIGHT;
+        }
+
+        return 0;
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    EvdevBackend::EvdevBackend()
+        : epollDescriptor(epoll_create1(EPOLL_CLOEXEC)),
+          notifyDescriptor(-1)
+    {
+        for (short i = 0; i < 4; i++) {
+            devices[i].descriptor = -1;
+        }
+    }
+
+    /*
+     * Destructor
+     *
+     * */
+    EvdevBackend::~EvdevBackend()
+    {
+        Close();
+
+        if (epollDescriptor >= 0) {
+            close(epollDescriptor);
+        }
+    }
+
+    /*
+     * Open() returns bool
+     *
+     * Opens every gamepad currently in /dev/input and starts watching the directory
+     * for gamepads that are plugged in later.
+     * Returns false if the directory could not be read.
+     * */
+    bool EvdevBackend::Open()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (notifyDescriptor < 0)
+        {
+            notifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+            if (notifyDescriptor >= 0)
+            {
+                struct epoll_event registration;
+
+                registration.events = EPOLLIN;
+                registration.data.u32 = EZX_NOTIFY_SLOT;
+
+                inotify_add_watch(notifyDescriptor, EZX_INPUT_DIRECTORY, IN_CREATE | IN_ATTRIB);
+                epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, notifyDescriptor, &registration);
+            }
+        }
+
+        DIR *directory = opendir(EZX_INPUT_DIRECTORY);
+
+        if (directory == NULL) {
+            return false;
+        }
+
+        while (struct dirent *entry = readdir(directory))
+        {
+            if (strncmp(entry->d_name, "event", 5) == 0)
+            {
+                char path[sizeof(EZX_INPUT_DIRECTORY "/") + NAME_MAX];
+
+                snprintf(path, sizeof(path), EZX_INPUT_DIRECTORY "/%s", entry->d_name);
+                OpenPath(path);
+            }
+        }
+
+        closedir(directory);
+
+        return true;
+    }
+
+    /*
+     * Close() returns nothing
+     *
+     * Closes every device and stops watching for new ones.
+     * */
+    void EvdevBackend::Close()
+    {
+        for (short i = 0; i < 4; i++) {
+            RemoveDevice(i);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (notifyDescriptor >= 0)
+        {
+            close(notifyDescriptor);
+            notifyDescriptor = -1;
+        }
+    }
+
+    /*
+     * AddDevice() returns short
+     *
+        * @param  An open, non-blocking descriptor that produces input_event records.
+        * @param  The slot to place the device in, or -1 for the first free slot.
+     *
+     * The backend takes ownership of the descriptor. Descriptors that are not evdev
+     * devices (pipes, for instance) are accepted and use default axis ranges.
+     * Returns the slot the device was placed in, or -1 if no slot was free.
+     * */
+    short EvdevBackend::AddDevice(
+        int descriptor,
+        short slot)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return Attach(descriptor, slot);
+    }
+
+    /*
+     * Attach() returns short
+     *
+        * @param  An open, non-blocking descriptor that produces input_event records.
+        * @param  The slot to place the device in, or -1 for the first free slot.
+     *
+     * Is called with the mutex held.
+     * */
+    short EvdevBackend::Attach(
+        int descriptor,
+        short slot)
+    {
+        if (slot < 0) {
+            for (short i = 0; i < 4 && slot < 0; i++) {
+                if (devices[i].descriptor < 0) {
+                    slot = i;
+                }
+            }
+        }
+
+        if (slot < 0 || slot >= 4 || devices[slot].descriptor >= 0)
+        {
+            close(descriptor);
+            return -1;
+        }
+
+        Device &device = devices[slot];
+        struct stat info;
+        unsigned char forceFeedback[(FF_MAX + 7) / 8] = {0};
+        unsigned char absolute[(ABS_MAX + 7) / 8] = {0};
+
+        ZeroMemory(&device.state, sizeof(XINPUT_STATE));
+        device.descriptor = descriptor;
+        device.node = (fstat(descriptor, &info) == 0 && S_ISCHR(info.st_mode)) ? info.st_rdev : 0;
+        device.dropped = false;
+        device.effectID = -1;
+
+        for (int axis = 0; axis <= ABS_HAT0Y; axis++)
+        {
+            struct input_absinfo range;
+
+            if (ioctl(descriptor, EVIOCGABS(axis), &range) == 0 && range.maximum > range.minimum)
+            {
+                device.ranges[axis].minimum = range.minimum;
+                device.ranges[axis].maximum = range.maximum;
+            }
+            else if (axis == ABS_Z || axis == ABS_RZ)
+            {
+                device.ranges[axis].minimum = 0;
+                device.ranges[axis].maximum = 255;
+            }
+            else if (axis >= ABS_HAT0X)
+            {
+                device.ranges[axis].minimum = -1;
+                device.ranges[axis].maximum = 1;
+            }
+            else
+            {
+                device.ranges[axis].minimum = -32768;
+                device.ranges[axis].maximum = 32767;
+            }
+        }
+
+        device.analogTriggers = ioctl(descriptor, EVIOCGBIT(EV_ABS, sizeof(absolute)), absolute) < 0
+                             || EZX_TEST_BIT(absolute, ABS_Z);
+        device.rumble = ioctl(descriptor, EVIOCGBIT(EV_FF, sizeof(forceFeedback)), forceFeedback) >= 0
+                     && EZX_TEST_BIT(forceFeedback, FF_RUMBLE);
+
+        if (device.node != 0) {
+            Resync(device);
+        }
+
+        struct epoll_event registration;
+
+        registration.events = EPOLLIN;
+        registration.data.u32 = (unsigned)slot;
+
+        epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &registration);
+
+        return slot;
+    }
+
+    /*
+     * RemoveDevice() returns nothing
+     *
+        * @param  The slot of the device to close.
+     * */
+    void EvdevBackend::RemoveDevice(
+        short slot)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (slot < 0 || slot >= 4 || devices[slot].descriptor < 0) {
+            return;
+        }
+
+        epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, devices[slot].descriptor, NULL);
+        close(devices[slot].descriptor);
+
+        devices[slot].descriptor = -1;
+    }
+
+    /*
+     * Pump() returns int
+     *
+        * @param  The longest time to wait for input in milliseconds, or -1 to wait indefinitely.
+        * @param  Optional pointer to a mask that the bit of each slot that had input is added to.
+     *
+     * Reads all pending input into the cached controller states.
+     * Returns the number of descriptors that had input.
+     * A device being plugged in or removed adds the bits of all four slots.
+     * */
+    int EvdevBackend::Pump(
+        int timeout,
+        unsigned int *slots)
+    {
+        struct epoll_event ready[8];
+        int count = epoll_wait(epollDescriptor, ready, 8, timeout);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (ready[i].data.u32 == EZX_NOTIFY_SLOT)
+            {
+                ReadNotifications();
+
+                if (slots) {
+                    *slots |= 0xF;
+                }
+            }
+            else
+            {
+                ReadDevice((short)ready[i].data.u32);
+
+                if (slots) {
+                    *slots |= 1u << ready[i].data.u32;
+                }
+            }
+        }
+
+        return count < 0 ? 0 : count;
+    }
+
+    /*
+     * GetState() returns DWORD
+     *
+        * @param  The slot to read.
+        * @param  The state to fill in.
+     *
+     * Returns ERROR_SUCCESS, or ERROR_DEVICE_NOT_CONNECTED if the slot is empty.
+     * */
+    DWORD EvdevBackend::GetState(
+        DWORD slot,
+        XINPUT_STATE *state)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (slot >= 4 || devices[slot].descriptor < 0) {
+            return ERROR_DEVICE_NOT_CONNECTED;
+        }
+
+        *state = devices[slot].state;
+
+        return ERROR_SUCCESS;
+    }
+
+    /*
+     * SetState() returns DWORD
+     *
+        * @param  The slot to write.
+        * @param  The motor speeds to set.
+     *
+     * Uploads the motor speeds as a force feedback rumble effect and plays it, or stops
+     * the effect when both speeds are zero.
+     * Returns ERROR_SUCCESS, or ERROR_DEVICE_NOT_CONNECTED if the slot is empty.
+     * */
+    DWORD EvdevBackend::SetState(
+        DWORD slot,
+        XINPUT_VIBRATION *vibration)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (slot >= 4 || devices[slot].descriptor < 0) {
+            return ERROR_DEVICE_NOT_CONNECTED;
+        }
+
+        Device &device = devices[slot];
+
+        if (!device.rumble) {
+            return ERROR_SUCCESS;
+        }
+
+        struct input_event play;
+
+        ZeroMemory(&play, sizeof(play));
+        play.type = EV_FF;
+
+        if (vibration->wLeftMotorSpeed == 0 && vibration->wRightMotorSpeed == 0)
+        {
+            if (device.effectID < 0) {
+                return ERROR_SUCCESS;
+            }
+
+            play.code = (unsigned short)device.effectID;
+            play.value = 0;
+
+            return write(device.descriptor, &play, sizeof(play)) == sizeof(play) ? ERROR_SUCCESS : ERROR_DEVICE_NOT_CONNECTED;
+        }
+
+        struct ff_effect effect;
+
+        ZeroMemory(&effect, sizeof(effect));
+        effect.type = FF_RUMBLE;
+        effect.id = device.effectID;
+        effect.u.rumble.strong_magnitude = vibration->wLeftMotorSpeed;
+        effect.u.rumble.weak_magnitude = vibration->wRightMotorSpeed;
+
+        if (ioctl(device.descriptor, EVIOCSFF, &effect) < 0) {
+            return ERROR_DEVICE_NOT_CONNECTED;
+        }
+
+        device.effectID = effect.id;
+        play.code = (unsigned short)effect.id;
+        play.value = 1;
+
+        return write(device.descriptor, &play, sizeof(play)) == sizeof(play) ? ERROR_SUCCESS : ERROR_DEVICE_NOT_CONNECTED;
+    }
+
+    /*
+     * GetFileDescriptor() returns int
+     *
+     * Returns the epoll descriptor, which is readable whenever Pump() has work to do.
+     * */
+    int EvdevBackend::GetFileDescriptor() const
+    {
+        return epollDescriptor;
+    }
+
+    /*
+     * IsGamepad() returns bool
+     *
+        * @param  The descriptor of an evdev device.
+     * */
+    bool EvdevBackend::IsGamepad(
+        int descriptor) const
+    {
+        unsigned char keys[(KEY_MAX + 7) / 8] = {0};
+
+        if (ioctl(descriptor, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) < 0) {
+            return false;
+        }
+
+        return EZX_TEST_BIT(keys, BTN_GAMEPAD);
+    }
+
+    /*
+     * FindDevice() returns short
+     *
+        * @param  The device number of an evdev node.
+     *
+     * Returns the slot of the device, or -1 if it is not open.
+     * */
+    short EvdevBackend::FindDevice(
+        dev_t node) const
+    {
+        for (short i = 0; i < 4; i++) {
+            if (devices[i].descriptor >= 0 && devices[i].node == node) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    /*
+     * OpenPath() returns nothing
+     *
+        * @param  The path of an evdev node.
+     *
+     * Opens the node if it is a gamepad that is not already open.
+     * Is called with the mutex held.
+     * */
+    void EvdevBackend::OpenPath(
+        const char *path)
+    {
+        struct stat info;
+
+        if (stat(path, &info) < 0 || !S_ISCHR(info.st_mode) || FindDevice(info.st_rdev) >= 0) {
+            return;
+        }
+
+        int descriptor = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+        if (descriptor < 0) {
+            descriptor = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        }
+
+        if (descriptor < 0) {
+            return;
+        }
+
+        if (!IsGamepad(descriptor))
+        {
+            close(descriptor);
+            return;
+        }
+
+        Attach(descriptor, -1);
+    }
+
+    /*
+     * ReadDevice() returns nothing
+     *
+        * @param  The slot of the device that has input.
+     *
+     * Removes the device if it has been unplugged.
+     * */
+    void EvdevBackend::ReadDevice(
+        short slot)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (slot < 0 || slot >= 4 || devices[slot].descriptor < 0) {
+            return;
+        }
+
+        Device &device = devices[slot];
+        struct input_event events[64];
+
+        for (;;)
+        {
+            ssize_t length = read(device.descriptor, events, sizeof(events));
+
+            if (length > 0)
+            {
+                for (size_t i = 0; i < (size_t)length / sizeof(input_event); i++) {
+                    HandleEvent(device, events[i]);
+                }
+            }
+            else if (length < 0 && (errno == EAGAIN || errno == EINTR))
+            {
+                break;
+            }
+            else
+            {
+                lock.unlock();
+                RemoveDevice(slot);
+                break;
+            }
+        }
+    }
+
+    /*
+     * ReadNotifications() returns nothing
+     *
+     * Opens any gamepads that have appeared in /dev/input.
+     * Nodes are reported both when created and when udev changes their permissions,
+     * since a new node is usually not readable until the latter.
+     * */
+    void EvdevBackend::ReadNotifications()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        alignas(struct inotify_event) char buffer[4096];
+        ssize_t length;
+
+        while ((length = read(notifyDescriptor, buffer, sizeof(buffer))) > 0)
+        {
+            for (char *position = buffer; position < buffer + length;)
+            {
+                struct inotify_event *notification = (struct inotify_event*)position;
+
+                if (notification->len > 0 && strncmp(notification->name, "event", 5) == 0)
+                {
+                    char path[sizeof(EZX_INPUT_DIRECTORY "/") + NAME_MAX];
+
+                    snprintf(path, sizeof(path), EZX_INPUT_DIRECTORY "/%s", notification->name);
+                    OpenPath(path);
+                }
+
+                position += sizeof(struct inotify_event) + notification->len;
+            }
+        }
+    }
+
+    /*
+     * HandleEvent() returns nothing
+     *
+        * @param  The device the event came from.
+        * @param  The event to apply to the device's state.
+     * */
+    void EvdevBackend::HandleEvent(
+        Device &device,
+        const input_event &event)
+    {
+        XINPUT_GAMEPAD &gamepad = device.state.Gamepad;
+
+        if (event.type == EV_SYN)
+        {
+            if (event.code == SYN_DROPPED)
+            {
+                device.dropped = true;
+            }
+            else if (event.code == SYN_REPORT)
+            {
+                if (device.dropped)
+                {
+                    device.dropped = false;
+                    Resync(device);
+                }
+
+                device.state.dwPacketNumber++;
+            }
+
+            return;
+        }
+
+        if (device.dropped) {
+            return;
+        }
+
+        if (event.type == EV_KEY)
+        {
+            WORD button = KeyCodeToButton(event.code);
+
+            if (button != 0)
+            {
+                gamepad.wButtons = event.value ? (gamepad.wButtons | button) : (gamepad.wButtons & ~button);
+            }
+            else if (!device.analogTriggers && event.code == BTN_TL2)
+            {
+                gamepad.bLeftTrigger = event.value ? 255 : 0;
+            }
+            else if (!device.analogTriggers && event.code == BTN_TR2)
+            {
+                gamepad.bRightTrigger = event.value ? 255 : 0;
+            }
+        }
+        else if (event.type == EV_ABS && event.code <= ABS_HAT0Y)
+        {
+            const AxisRange &range = device.ranges[event.code];
+
+            switch (event.code)
+            {
+            case ABS_X:  gamepad.sThumbLX = ScaleStick(event.value, range.minimum, range.maximum, false); break;
+            case ABS_Y:  gamepad.sThumbLY = ScaleStick(event.value, range.minimum, range.maximum, true);  break;
+            case ABS_RX: gamepad.sThumbRX = ScaleStick(event.value, range.minimum, range.maximum, false); break;
+            case ABS_RY: gamepad.sThumbRY = ScaleStick(event.value, range.minimum, range.maximum, true);  break;
+            case ABS_Z:  gamepad.bLeftTrigger = ScaleTrigger(event.value, range.minimum, range.maximum);  break;
+            case ABS_RZ: gamepad.bRightTrigger = ScaleTrigger(event.value, range.minimum, range.maximum); break;
+
+            case ABS_HAT0X:
+                gamepad.wButtons &= ~(XINPUT_GAMEPAD_DPAD_LEFT | XINPUT_GAMEPAD_DPAD_RIGHT);
+                gamepad.wButtons |= event.value < 0 ? XINPUT_GAMEPAD_DPAD_LEFT : (event.value > 0 ? XINPUT_GAMEPAD_DPAD_RIGHT : 0);
+                break;
+
+            case ABS_HAT0Y:
+                gamepad.wButtons &= ~(XINPUT_GAMEPAD_DPAD_UP | XINPUT_GAMEPAD_DPAD_DOWN);
+                gamepad.wButtons |= event.value < 0 ? XINPUT_GAMEPAD_DPAD_UP : (event.value > 0 ? XINPUT_GAMEPAD_DPAD_DOWN : 0);
+                break;
+            }
+        }
+    }
+
+    /*
+     * Resync() returns nothing
+     *
+        * @param  The device to resynchronize.
+     *
+     * Rebuilds the device's state from the kernel's copy, after the device was opened
+     * or after the kernel dropped events because they were not read quickly enough.
+     * */
+    void EvdevBackend::Resync(
+        Device &device)
+    {
+        unsigned char keys[(KEY_MAX + 7) / 8] = {0};
+        DWORD packetNumber = device.state.dwPacketNumber;
+        input_event event;
+
+        ZeroMemory(&device.state, sizeof(XINPUT_STATE));
+        ZeroMemory(&event, sizeof(event));
+        device.state.dwPacketNumber = packetNumber;
+
+        if (ioctl(device.descriptor, EVIOCGKEY(sizeof(keys)), keys) >= 0)
+        {
+            event.type = EV_KEY;
+
+            for (unsigned short code = BTN_GAMEPAD; code <= BTN_DPAD_RIGHT; code++)
+            {
+                event.code = code;
+                event.value = EZX_TEST_BIT(keys, code);
+                HandleEvent(device, event);
+            }
+        }
+
+        event.type = EV_ABS;
+
+        for (unsigned short axis = 0; axis <= ABS_HAT0Y; axis++)
+        {
+            struct input_absinfo range;
+
+            if (ioctl(device.descriptor, EVIOCGABS(axis), &range) >= 0)
+            {
+                event.code = axis;
+                event.value = range.value;
+                HandleEvent(device, event);
+            }
+        }
+    }
+
+    /*
+     * GetDefaultBackend() returns EvdevBackend&
+     *
+     * Returns the backend used by XInputGetState() and XInputSetState(), opening it
+     * the first time it is used.
+     * */
+    EvdevBackend& GetDefaultBackend()
+    {
+        static struct Opened
+        {
+            EvdevBackend backend;
+            Opened() { backend.Open(); }
+        } opened;
+
+        return opened.backend;
+    }
+}
+
+/*
+ * XInputGetState() returns DWORD
+ *
+    * @param  The slot to read.
+    * @param  The state to fill in.
+ * */
+DWORD XInputGetState(
+    DWORD userIndex,
+    XINPUT_STATE *state)
+{
+    ezx::EvdevBackend &backend = ezx::GetDefaultBackend();
+
+    backend.Pump(0);
+
+    return backend.GetState(userIndex, state);
+}
+
+/*
+ * XInputSetState() returns DWORD
+ *
+    * @param  The slot to write.
+    * @param  The motor speeds to set.
+ * */
+DWORD XInputSetState(
+    DWORD userIndex,
+    XINPUT_VIBRATION *vibration)
+{
+    return ezx::GetDefaultBackend().SetState(userIndex, vibration);
+}
+
+#endif
\ No newline at end of file
@@ -36,7 +36,8 @@ namespace ezx
         : controllerId(-1),
           type(0),
           which(0),
-          angle(0)
+          angle(0),
+          timestamp(0)
     {
         /* Intentionally left blank. */
     }
@@ -50,7 +51,8 @@ namespace ezx
      *
      * This constructor is used for non-analog events.
      * Those events are the following:
-        * EZX_PRESS, EZX_RELEASE, EZX_CONNECT, EZX_DISCONNECT
+        * EZX_PRESS, EZX_RELEASE, EZX_CONNECT, EZX_DISCONNECT,
+        * EZX_LONG_PRESS, EZX_REPEAT, EZX_DOUBLE_TAP
      * */
     Event::Event(
         short controllerId,
@@ -59,7 +61,8 @@ namespace ezx
         : controllerId(controllerId),
           type(type),
           which(which),
-          angle(0)
+          angle(0),
+          timestamp(0)
     {
         /* Intentionally left blank. */
     }
@@ -74,7 +77,7 @@ namespace ezx
     *
      * This constructor is used for analog events.
      * Those events are the following:
-        * EZX_ANALOG
+        * EZX_ANALOG, EZX_DIRECTION (where the angle is one of the EZX_DIR_ values)
      * */
     Event::Event(
         short controllerId,
@@ -84,7 +87,8 @@ namespace ezx
         : controllerId(controllerId),
           type(type),
           which(which),
-          angle(angle)
+          angle(angle),
+          timestamp(0)
     {
         /* Intentionally left blank. */
     }
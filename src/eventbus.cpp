@@ -0,0 +1,275 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "eventbus.hpp"
+
+/*
+ * The sequence number of a slot that is being written, or has never been written.
+ * */
+#define EZX_INVALID_SEQUENCE 0xFFFFFFFFFFFFFFFFULL
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+        * @param  The number of events the bus holds. Will be rounded up to a power of two.
+     * */
+    EventBus::EventBus(
+        std::size_t capacity)
+        : slots(NULL),
+          mask(0),
+          published(0),
+          overruns(0)
+    {
+        std::size_t size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        slots = new Slot[size];
+        mask = size - 1;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            slots[i].sequence.store(EZX_INVALID_SEQUENCE, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * Destructor
+     *
+     * */
+    EventBus::~EventBus()
+    {
+        delete [] slots;
+    }
+
+    /*
+     * Publish() returns nothing
+     *
+        * @param  The event to publish.
+     *
+     * Writes the event into the next slot of the ring, overwriting the oldest event once the
+     * ring is full. Must only ever be called by one thread at a time.
+     *
+     * The slot's sequence number is invalidated while the event is being written, so that a
+     * subscriber reading the slot at the same time knows to discard what it read.
+     * */
+    void EventBus::Publish(
+        const Event &event)
+    {
+        unsigned long long sequence = published.load(std::memory_order_relaxed);
+        Slot &slot = slots[sequence & mask];
+
+        slot.sequence.store(EZX_INVALID_SEQUENCE, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.event = event;
+
+        slot.sequence.store(sequence, std::memory_order_release);
+        published.store(sequence + 1, std::memory_order_release);
+    }
+
+    /*
+     * GetCapacity() returns std::size_t
+     *
+     * Returns the number of events the bus holds before it starts overwriting them.
+     * */
+    std::size_t EventBus::GetCapacity() const
+    {
+        return mask + 1;
+    }
+
+    /*
+     * GetOverrunCount() returns unsigned long long
+     *
+     * Returns the number of times a subscriber fell so far behind that events were
+     * overwritten before it could read them.
+     * */
+    unsigned long long EventBus::GetOverrunCount() const
+    {
+        return overruns.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * GetSequence() returns unsigned long long
+     *
+     * Returns the total number of events that have been published.
+     * */
+    unsigned long long EventBus::GetSequence() const
+    {
+        return published.load(std::memory_order_acquire);
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The bus to subscribe to.
+     * */
+    EventSubscriber::EventSubscriber(
+        const EventBus &bus)
+        : bus(&bus),
+          cursor(bus.GetSequence()),
+          lost(0)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * CatchUp() returns nothing
+     *
+        * @param  The number of events published so far.
+     *
+     * If the producer has lapped this subscriber, skips its cursor forward to the oldest
+     * event that is still in the ring and counts the events that were skipped.
+     * */
+    void EventSubscriber::CatchUp(
+        unsigned long long published)
+    {
+        unsigned long long capacity = bus->mask + 1;
+
+        if (published - cursor > capacity)
+        {
+            lost += (published - capacity) - cursor;
+            cursor = published - capacity;
+
+            bus->overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * Peek() returns bool
+     *
+        * @param  Pointer to store the address of the next event in.
+     *
+     * Gives direct access to the next unread event inside the ring without copying it.
+     * The event stays valid until the producer wraps around the ring; call Advance() once
+     * done with it to find out whether that happened.
+     * Will return false if there are no unread events.
+     * */
+    bool EventSubscriber::Peek(
+        const Event **event)
+    {
+        if (event == NULL) {
+            return false;
+        }
+
+        while (true)
+        {
+            unsigned long long published = bus->published.load(std::memory_order_acquire);
+
+            if (cursor == published) {
+                return false;
+            }
+
+            CatchUp(published);
+
+            const EventBus::Slot &slot = bus->slots[cursor & bus->mask];
+
+            if (slot.sequence.load(std::memory_order_acquire) == cursor)
+            {
+                *event = &slot.event;
+                return true;
+            }
+        }
+    }
+
+    /*
+     * Advance() returns bool
+     *
+     * Moves past the event returned by Peek().
+     * Will return false if the event was overwritten while it was being used,
+     * in which case whatever was read from it must be discarded.
+     * */
+    bool EventSubscriber::Advance()
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        const EventBus::Slot &slot = bus->slots[cursor & bus->mask];
+        bool valid = slot.sequence.load(std::memory_order_relaxed) == cursor;
+
+        if (valid) {
+            ++cursor;
+        } else {
+            CatchUp(bus->published.load(std::memory_order_acquire));
+        }
+
+        return valid;
+    }
+
+    /*
+     * Read() returns bool
+     *
+        * @param  Pointer to the Event object to provide data to.
+     *
+     * Copies the next unread event. Events that were overwritten before they could be read
+     * are skipped (see GetLostCount()).
+     * Will only ever return true if there was an event to read.
+     * */
+    bool EventSubscriber::Read(
+        Event *event)
+    {
+        const Event *next;
+
+        if (event == NULL) {
+            return false;
+        }
+
+        while (Peek(&next))
+        {
+            *event = *next;
+
+            if (Advance()) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+     * GetLostCount() returns unsigned long long
+     *
+     * Returns the number of events this subscriber missed because it fell behind the producer
+     * by more than the capacity of the bus.
+     * */
+    unsigned long long EventSubscriber::GetLostCount() const
+    {
+        return lost;
+    }
+
+    /*
+     * GetPendingCount() returns unsigned long long
+     *
+     * Returns the number of events published that this subscriber has not read yet.
+     * */
+    unsigned long long EventSubscriber::GetPendingCount() const
+    {
+        return bus->GetSequence() - cursor;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,321 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "framehistory.hpp"
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+     * */
+    PackedState::PackedState()
+        : buttons(0),
+          leftTrigger(0),
+          rightTrigger(0),
+          thumbLX(0),
+          thumbLY(0),
+          thumbRX(0),
+          thumbRY(0)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The XINPUT gamepad state to pack.
+     * */
+    PackedState::PackedState(
+        const XINPUT_GAMEPAD &gamepad)
+        : buttons(gamepad.wButtons),
+          leftTrigger(gamepad.bLeftTrigger),
+          rightTrigger(gamepad.bRightTrigger),
+          thumbLX(gamepad.sThumbLX),
+          thumbLY(gamepad.sThumbLY),
+          thumbRX(gamepad.sThumbRX),
+          thumbRY(gamepad.sThumbRY)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * operator == returns bool
+     *
+        * @param  The state to compare against.
+     * */
+    bool
+    PackedState::operator == (
+        const PackedState &other) const
+    {
+        return buttons == other.buttons
+            && leftTrigger == other.leftTrigger
+            && rightTrigger == other.rightTrigger
+            && thumbLX == other.thumbLX
+            && thumbLY == other.thumbLY
+            && thumbRX == other.thumbRX
+            && thumbRY == other.thumbRY;
+    }
+
+    /*
+     * operator != returns bool
+     *
+        * @param  The state to compare against.
+     * */
+    bool
+    PackedState::operator != (
+        const PackedState &other) const
+    {
+        return !(*this == other);
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The number of frames to hold. Will be rounded up to a power of two.
+     * */
+    FrameHistory::FrameHistory(
+        unsigned int capacity)
+        : frames(NULL),
+          mask(0),
+          newestFrame(0)
+    {
+        unsigned int size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        frames = new Frame[size];
+        mask = size - 1;
+
+        for (unsigned int i = 0; i < size; ++i) {
+            frames[i].valid = false;
+        }
+    }
+
+    /*
+     * Destructor
+     *
+     * */
+    FrameHistory::~FrameHistory()
+    {
+        delete [] frames;
+    }
+
+    /*
+     * Find() returns const Frame*
+     *
+        * @param  The number of the frame to find.
+     *
+     * Returns NULL if the frame was never recorded or has already been overwritten.
+     * */
+    const FrameHistory::Frame* FrameHistory::Find(
+        unsigned long frame) const
+    {
+        const Frame *slot = &frames[frame & mask];
+        return (slot->valid && slot->number == frame) ? slot : NULL;
+    }
+
+    /*
+     * CompareFrames() returns unsigned char
+     *
+        * @param  The frame before the compared frame, or NULL if it is not held by the history.
+        * @param  The frame to compare.
+     *
+     * Returns a bit for each controller whose state or connection differs between the frames.
+     * Every controller counts as changed if there is no previous frame.
+     * */
+    unsigned char FrameHistory::CompareFrames(
+        const Frame *previous,
+        const Frame &frame)
+    {
+        unsigned char changed = 0;
+
+        for (short i = 0; i < 4; ++i)
+        {
+            unsigned char bit = (unsigned char)(1 << i);
+
+            if (previous == NULL || (previous->connected & bit) != (frame.connected & bit) || previous->states[i] != frame.states[i]) {
+                changed |= bit;
+            }
+        }
+
+        return changed;
+    }
+
+    /*
+     * Record() returns nothing
+     *
+        * @param  The number of the frame.
+        * @param  The packed state of each of the four controllers.
+        * @param  The connection state of each of the four controllers.
+     *
+     * Stores the states of a frame, overwriting the oldest frame once the ring is full.
+     * A controller's state counts as changed if it differs from the previous frame, or if the
+     * previous frame was never recorded.
+     *
+     * Recording a frame again (e.g. to correct it after a rollback) also compares the next
+     * frame against the corrected one, if the history holds it.
+     * */
+    void FrameHistory::Record(
+        unsigned long frame,
+        const PackedState states[4],
+        const bool connected[4])
+    {
+        Frame &slot = frames[frame & mask];
+
+        slot.number = frame;
+        slot.valid = true;
+        slot.connected = 0;
+
+        for (short i = 0; i < 4; ++i)
+        {
+            slot.states[i] = connected[i] ? states[i] : PackedState();
+
+            if (connected[i]) {
+                slot.connected |= (unsigned char)(1 << i);
+            }
+        }
+
+        slot.changed = CompareFrames(Find(frame - 1), slot);
+
+        Frame &next = frames[(frame + 1) & mask];
+
+        if (next.valid && next.number == frame + 1) {
+            next.changed = CompareFrames(&slot, next);
+        }
+
+        if (frame > newestFrame || Find(newestFrame) == NULL) {
+            newestFrame = frame;
+        }
+    }
+
+    /*
+     * HasFrame() returns bool
+     *
+        * @param  The number of the frame.
+     *
+     * Returns true if the frame is still held by the history.
+     * */
+    bool FrameHistory::HasFrame(
+        unsigned long frame) const
+    {
+        return Find(frame) != NULL;
+    }
+
+    /*
+     * GetState() returns bool
+     *
+        * @param  The number of the frame.
+        * @param  The ID of the controller. Will be an integer between 0-3.
+        * @param  Pointer to store the state in.
+     *
+     * Will return false if the frame is not held by the history.
+     * */
+    bool FrameHistory::GetState(
+        unsigned long frame,
+        short controllerID,
+        PackedState *state) const
+    {
+        const Frame *slot = Find(frame);
+
+        if (slot == NULL || state == NULL || controllerID < 0 || controllerID > 3) {
+            return false;
+        }
+
+        *state = slot->states[controllerID];
+        return true;
+    }
+
+    /*
+     * IsConnected() returns bool
+     *
+        * @param  The number of the frame.
+        * @param  The ID of the controller. Will be an integer between 0-3.
+     *
+     * Returns true if the controller was connected during the frame.
+     * */
+    bool FrameHistory::IsConnected(
+        unsigned long frame,
+        short controllerID) const
+    {
+        const Frame *slot = Find(frame);
+        return slot != NULL && controllerID >= 0 && controllerID < 4 && (slot->connected & (1 << controllerID));
+    }
+
+    /*
+     * Differs() returns bool
+     *
+        * @param  The number of the frame.
+     *
+     * Returns true if any controller's state in the frame differs from the frame before it.
+     * Frames that are not held by the history always count as different.
+     * */
+    bool FrameHistory::Differs(
+        unsigned long frame) const
+    {
+        const Frame *slot = Find(frame);
+        return slot == NULL || slot->changed != 0;
+    }
+
+    /*
+     * Differs() returns bool
+     *
+        * @param  The number of the frame.
+        * @param  The ID of the controller. Will be an integer between 0-3.
+     *
+     * Returns true if the controller's state in the frame differs from the frame before it.
+     * */
+    bool FrameHistory::Differs(
+        unsigned long frame,
+        short controllerID) const
+    {
+        const Frame *slot = Find(frame);
+        return slot == NULL || controllerID < 0 || controllerID > 3 || (slot->changed & (1 << controllerID));
+    }
+
+    /*
+     * GetCapacity() returns unsigned int
+     *
+     * Returns the number of frames the history holds.
+     * */
+    unsigned int FrameHistory::GetCapacity() const
+    {
+        return mask + 1;
+    }
+
+    /*
+     * GetNewestFrame() returns unsigned long
+     *
+     * Returns the number of the most recently recorded frame.
+     * */
+    unsigned long FrameHistory::GetNewestFrame() const
+    {
+        return newestFrame;
+    }
+}
\ No newline at end of file
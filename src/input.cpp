@@ -24,276 +24,30 @@
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 * */
 
-#include "input.hpp"
-
-#include <algorithm>
-#include <queue>
 
-/*
- * Some macros that make the code below a little easier to read.
- * All of them are used for creating arrays.
- * */
-#define EZX_ANALOG_STICK_ANGLES(state) {(state).Gamepad.sThumbLX, (state).Gamepad.sThumbLY, (state).Gamepad.sThumbRX, (state).Gamepad.sThumbRY}
-#define EZX_TRIGGER_ANGLES(state)      {(state).Gamepad.bLeftTrigger, (state).Gamepad.bRightTrigger}
-#define EZX_BUTTONS                    {XINPUT_GAMEPAD_START,XINPUT_GAMEPAD_BACK,XINPUT_GAMEPAD_DPAD_UP,XINPUT_GAMEPAD_DPAD_DOWN,XINPUT_GAMEPAD_DPAD_LEFT,XINPUT_GAMEPAD_DPAD_RIGHT,XINPUT_GAMEPAD_A,XINPUT_GAMEPAD_B,XINPUT_GAMEPAD_X,XINPUT_GAMEPAD_Y,XINPUT_GAMEPAD_LEFT_THUMB,XINPUT_GAMEPAD_RIGHT_THUMB,XINPUT_GAMEPAD_LEFT_SHOULDER,XINPUT_GAMEPAD_RIGHT_SHOULDER}
-#define EZX_ANALOG_STICK_DEADZONES     {XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE}
-#define EZX_ANALOG_ANGLES_ARRAY_INIT   {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}}
-#define EZX_BUTTONS_DOWN_ARRAY_INIT    {EZX_FALSE_ARRAY, EZX_FALSE_ARRAY, EZX_FALSE_ARRAY, EZX_FALSE_ARRAY}
-#define EZX_FALSE_ARRAY                {false, false, false, false, false, false, false, false, false, false, false, false, false, false}
-#define EZX_CONNECTIONS_ARRAY_INIT     {false, false, false, false}
+#include "input.hpp"
+#include "context.hpp"
 
 namespace ezx
 {
-    /*
-     * Arrays of IDs/values that are used by the detection functions.
-     * */
-    const int BUTTONS[14] = EZX_BUTTONS;
-    const int DEADZONES[4] = EZX_ANALOG_STICK_DEADZONES;
-
-    /*
-     * The main event queue.
-     * Is populated by the Detect functions below.
-     * */
-    std::queue<Event> eventQueue;
-
-    /*
-     * Arrays of statuses that are used by the detection functions.
-     * Each array is two-dimensional; one for each of the four controllers.
-     * */
-    namespace status
-    {
-        short analogAngles[4][6] = EZX_ANALOG_ANGLES_ARRAY_INIT;
-        bool  controllersDetected[4];
-        bool  buttonsDown[4][14];
-    }
-
-    /*
-     * AnalogAngleIDToButtonID() returns int
-     *
-        * @param  The ID of the analog button.
-     *
-     * Each analog is given a unique ID (which are used for getting/setting values
-     * from arrays) and this function converts those analog IDs to their equivalent button IDs.
-     * */
-    int AnalogAngleIDToButtonID(
-        short analogID)
-    {
-        switch (analogID)
-        {
-        case 0:  return EZX_LTRIGGER;
-        case 1:  return EZX_RTRIGGER;
-        case 2:  return EZX_LTHUMB_X;
-        case 3:  return EZX_LTHUMB_Y;
-        case 4:  return EZX_RTHUMB_X;
-        case 5:  return EZX_RTHUMB_Y;
-        default: return -1;
-        }
-    }
-
-    /*
-     * DetectConnection() returns nothing
-     *
-        * @param  The ID of the controller to detect a connection for.
-     *
-     * Detects if the controller determined by the passed ID just connected.
-     * If the controller is already connected, or not connected at all,
-     * this function will do nothing.
-     * */
-    inline void DetectConnection(
-        short controllerID)
-    {
-        if (status::controllersDetected[controllerID] == false)
-        {
-            status::controllersDetected[controllerID] = true;
-            eventQueue.push(Event(controllerID, EZX_CONNECT, controllerID));
-        }
-    }
-
-    /*
-     * DetectDisconnection() returns nothing
-     *
-        * @param  The ID of the controller to detect a disconnection for.
-     *
-     * Detects if the controller determined by the passed ID just disconnected.
-     * If the controller is already disconnected or connected this function will do nothing.
-     * */
-    inline void DetectDisconnection(
-        short controllerID)
-    {
-        if (status::controllersDetected[controllerID])
-        {
-            status::controllersDetected[controllerID] = false;
-            eventQueue.push(Event(controllerID, EZX_DISCONNECT, controllerID));
-        }
-    }
-
-    /*
-     * DetectPressedAnalog()
-     *
-        * @param  The controller ID to detect analog presses for.
-        * @param  The analog ID to detect. Will be an integer between 2-5.
-        * @param  The current angle of the analog.
-        * @param  Pointer to the XINPUT state to be used.
-     *
-     * */
-    inline void DetectPressedAnalog(
-        short controllerID,
-        short analogAngleID,
-        short angle,
-        PXINPUT_STATE state)
-    {
-        int buttonID = AnalogAngleIDToButtonID(analogAngleID);
-
-        if (status::analogAngles[controllerID][analogAngleID] != angle) {
-            eventQueue.push(Event(controllerID, EZX_ANALOG, buttonID, angle));
-        }
-
-        status::analogAngles[controllerID][analogAngleID] = angle;
-        eventQueue.push(Event(controllerID, EZX_PRESS, buttonID, angle));
-    }
-
-    /*
-     * DetectReleasedAnalog()
-     *
-        * @param  The controller ID to detect analog releases for.
-        * @param  The analog ID to detect. Will be an integer between 2-5.
-        * @param  The current angle of the analog.
-        * @param  Pointer to the XINPUT state to be used.
-     *
-     * */
-    inline void DetectReleasedAnalog(
-        short controllerID,
-        short analogAngleID,
-        PXINPUT_STATE state)
-    {
-        int buttonID = AnalogAngleIDToButtonID(analogAngleID);
-
-        if (status::analogAngles[controllerID][analogAngleID]) {
-            eventQueue.push(Event(controllerID, EZX_RELEASE, buttonID));
-        }
-
-        status::analogAngles[controllerID][analogAngleID] = 0;
-    }
-
-    /*
-     * DetectTriggers() returns nothing
-     *
-        * @param  The ID of the controller to detect the trigger angles for.
-        * @param  Pointer to the XINPUT state object.
-     *
-     * */
-    void DetectTriggers(
-        short controllerID,
-        PXINPUT_STATE state)
-    {
-        unsigned char angles[2] = EZX_TRIGGER_ANGLES(*state);
-
-        for (char i = 0; i < 2; i++)
-        {
-            if (angles[i] > 0) {
-                DetectPressedAnalog(controllerID, i, angles[i], state);
-            } else {
-                DetectReleasedAnalog(controllerID, i, state);
-            }
-        }
-    }
-
-    /*
-     * DetectAnalogSticks() returns nothing
-     * 
-        * @param
-        * @param
-     *
-     * */
-    void DetectAnalogSticks(
-        short controllerID,
-        PXINPUT_STATE state)
-    {
-        short angles[4] = EZX_ANALOG_STICK_ANGLES(*state);
-
-        for (char i = 0; i < 4; i++)
-        {
-            char j = i+2;
-
-            if (angles[i] >= DEADZONES[i] || angles[i] <= -DEADZONES[i]) {
-                DetectPressedAnalog(controllerID, j, angles[i], state);
-            } else {
-                DetectReleasedAnalog(controllerID, j, state);
-            }
-        }
-    }
-
-    /*
-     * DetectButtons()
-     *
-        * @param  The controller ID to detect buttons for.
-        * @param  Pointer to the XINPUT state to be used.
-     *
-     * */
-    void DetectButtons(
-        short controllerID,
-        PXINPUT_STATE state)
-    {
-        /*
-         * Iterate once for each of these fourteen buttons:
-         * A, B, X, Y, DPAD-UP, DPAD-DOWN, DPAD-LEFT, DPAD-RIGHT,
-         * START, BACK, LEFT SHOULDER, RIGHT SHOULDER,
-         * LEFT THUMB STICK, RIGHT THUMB STICK
-         * */
-        for (char i = 0; i < 14; ++i)
-        {
-            if (state->Gamepad.wButtons & BUTTONS[i])
-            {
-                status::buttonsDown[controllerID][i] = true;
-                eventQueue.push(Event(controllerID, EZX_PRESS, BUTTONS[i]));
-            }
-            else
-            {
-                if (status::buttonsDown[controllerID][i]) {
-                    eventQueue.push(Event(controllerID, EZX_RELEASE, BUTTONS[i]));
-                }
-
-                status::buttonsDown[controllerID][i] = false;
-            }
-        }
-    }
-
     /*
      * DetectInput() returns nothing
      *
-     * Performs an update on the controller detection.
+     * Performs an update on the controller detection of the default context.
      * This is the function that builds the events used in the message loop.
      * */
     void DetectInput()
     {
-        XINPUT_STATE state;
-        ZeroMemory(&state, sizeof XINPUT_STATE);
-
-        /* 
-         * Iterate once for each possible controller.
-         * The "i" variable is used as the controller index.
-         * */
-        for (char i = 0; i < 4; ++i)
-        {
-            if (XInputGetState(i, &state) == ERROR_SUCCESS)
-            {
-                DetectConnection(i);
-                DetectAnalogSticks(i, &state);
-                DetectTriggers(i, &state);
-                DetectButtons(i, &state);
-            } else {
-                DetectDisconnection(i);
-            }
-        }
+        GetDefaultContext().DetectInput();
     }
 
     /*
      * FlushEvents() returns nothing
-     * Removes all current Event objects in the event queue.
+     * Removes all current Event objects in the event queue of the default context.
      * */
     void FlushEvents()
     {
-        std::swap(eventQueue, std::queue<Event>());
+        GetDefaultContext().FlushEvents();
     }
 
     /*
@@ -317,7 +71,7 @@ namespace ezx
         else
         {
             XINPUT_STATE state;
-            ZeroMemory(&state, sizeof XINPUT_STATE);
+            ZeroMemory(&state, sizeof(XINPUT_STATE));
 
             states->first = (XInputGetState(0,&state)==ERROR_SUCCESS);
             states->second = (XInputGetState(1,&state)==ERROR_SUCCESS);
@@ -333,96 +87,117 @@ namespace ezx
      *
          * @param  Pointer to the Event object to provide data to.
      *
-     * The function which controls the message loop.
+     * The function which controls the message loop of the default context.
      * Will only ever return true if there are events to be handled.
      * */
     bool GetEvent(
         Event *event)
     {
-        if (event == NULL) {
-            return false;
-        }
-        else
-        {
-            std::queue<Event>::size_type previousSize = eventQueue.size();
-
-            if (previousSize > 0)
-            {
-                *event = eventQueue.front();
-                eventQueue.pop();
-            }
-
-            return previousSize != eventQueue.size();
-        }
+        return GetDefaultContext().GetEvent(event);
     }
 
     /*
-     * SetVibrationAmount() returns nothing
+     * WaitForEvent() returns bool
      *
-        * @param  The ID of the controller to be vibrated.
-        * @param  The amount to vibrate both sides by, between 0 and 65535.
+        * @param  Pointer to the Event object to provide data to.
+        * @param  The longest time to wait in milliseconds, or EZX_WAIT_INFINITE.
      *
+     * Like GetEvent(), but waits for an event to be detected by the default context
+     * if there are none to be handled (see Context::WaitForEvent()).
      * */
-    void SetVibrationAmount(
-        short controllerID,
-        WORD vibration)
+    bool WaitForEvent(
+        Event *event,
+        unsigned int timeout)
     {
-        SetVibrationAmount(controllerID, vibration, vibration);
+        return GetDefaultContext().WaitForEvent(event, timeout);
     }
 
     /*
-     * SetVibrationAmount() returns nothing
+     * PredictAnalog() returns bool
      *
-        * @param  The ID of the controller to be vibrated.
-        * @param  The amount to vibrate the left side by, between 0 and 65535.
-        * @param  The amount to vibrate the right side by, between 0 and 65535.
+        * @param  The ID of the controller.
+        * @param  The ID of the analog, e.g. EZX_LTHUMB_X or EZX_RTRIGGER.
+        * @param  The time to predict the value at (see ezx::GetTimestamp()).
+        * @param  Pointer to store the predicted value in.
      *
+     * Estimates the value of an analog of the default context at the passed time using
+     * filtered extrapolation (see Context::PredictAnalog()).
      * */
-    void SetVibrationAmount(
+    bool PredictAnalog(
         short controllerID,
-        WORD leftVibration,
-        WORD rightVibration)
+        int which,
+        long long timestamp,
+        short *value)
     {
-        XINPUT_VIBRATION vibrate;
-        ZeroMemory(&vibrate, sizeof XINPUT_VIBRATION);
+        return GetDefaultContext().PredictAnalog(controllerID, which, timestamp, EZX_PREDICT_FILTERED, value);
+    }
 
-        vibrate.wLeftMotorSpeed = leftVibration;
-        vibrate.wRightMotorSpeed = rightVibration;
+    /*
+     * GetMetrics() returns bool
+     *
+        * @param  The Metrics object to store the snapshot in.
+     *
+     * Copies the current value of every pipeline counter of the default context into the
+     * passed object. Will return false if a NULL pointer is given.
+     * */
+    bool GetMetrics(
+        Metrics *metrics)
+    {
+        return GetDefaultContext().GetMetrics(metrics);
+    }
 
-        XInputSetState(controllerID, &vibrate);
+    /*
+     * ResetMetrics() returns nothing
+     * Sets every pipeline counter of the default context back to zero.
+     * */
+    void ResetMetrics()
+    {
+        GetDefaultContext().ResetMetrics();
     }
 
     /*
-     * SetVibrationLevel() returns nothing
+     * AnalogAngleIDToButtonID() returns int
      *
-        * @param  The ID of the controller to be vibrated.
-        * @param  The amount to vibrate both sides by, between 0.0 and 1.0.
+        * @param  The ID of the analog button.
      *
+     * Each analog is given a unique ID (which are used for getting/setting values
+     * from arrays) and this function converts those analog IDs to their equivalent button IDs.
      * */
-    void SetVibrationLevel(
-        short controllerID,
-        float vibrationPercentage)
+    int AnalogAngleIDToButtonID(
+        short analogID)
     {
-        WORD vibration = (WORD)(65535.0f * vibrationPercentage);
-        SetVibrationAmount(controllerID, vibration, vibration);
+        switch (analogID)
+        {
+        case 0:  return EZX_LTRIGGER;
+        case 1:  return EZX_RTRIGGER;
+        case 2:  return EZX_LTHUMB_X;
+        case 3:  return EZX_LTHUMB_Y;
+        case 4:  return EZX_RTHUMB_X;
+        case 5:  return EZX_RTHUMB_Y;
+        default: return -1;
+        }
     }
 
     /*
-     * SetVibrationLevel() returns nothing
+     * ButtonIDToAnalogAngleID() returns short
      *
-        * @param  The ID of the controller to be vibrated.
-        * @param  The amount to vibrate the left side by, between 0.0 and 1.0.
-        * @param  The amount to vibrate the right side by, between 0.0 and 1.0.
+        * @param  The button ID of the analog, e.g. EZX_LTRIGGER.
      *
+     * The inverse of AnalogAngleIDToButtonID().
+     * Returns -1 if the button ID is not an analog.
      * */
-    void SetVibrationLevel(
-        short controllerID,
-        float leftVibrationPercentage,
-        float rightVibrationPercentage)
+    short ButtonIDToAnalogAngleID(
+        int buttonID)
     {
-        WORD leftVibration = (WORD)(65535.0f * leftVibrationPercentage);
-        WORD rightVibration = (WORD)(65535.0f * rightVibrationPercentage);
-
-        SetVibrationAmount(controllerID, leftVibration, rightVibration);
+        switch (buttonID)
+        {
+        case EZX_LTRIGGER: return 0;
+        case EZX_RTRIGGER: return 1;
+        case EZX_LTHUMB_X: return 2;
+        case EZX_LTHUMB_Y: return 3;
+        case EZX_RTHUMB_X: return 4;
+        case EZX_RTHUMB_Y: return 5;
+        default:           return -1;
+        }
     }
 }
\ No newline at end of file
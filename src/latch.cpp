@@ -0,0 +1,300 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "latch.hpp"
+#include "clock.hpp"
+
+#include <chrono>
+#include <thread>
+
+/*
+ * The estimates are smoothed like round-trip times in TCP: the mean with a weight of 1/8
+ * per measurement, the mean deviation with a weight of 1/4, and samples are planned
+ * EZX_LATCH_DEVIATIONS deviations above the mean.
+ * */
+#define EZX_LATCH_MEAN_SHIFT      3
+#define EZX_LATCH_DEVIATION_SHIFT 2
+#define EZX_LATCH_DEVIATIONS      4
+
+/*
+ * How long before the planned start of a sample the thread stops sleeping and yields
+ * instead, in addition to the measured wake error.
+ * */
+#define EZX_LATCH_SPIN 100
+
+namespace ezx
+{
+    /*
+     * Smooth() returns nothing
+     *
+        * @param  The mean of the measurements so far.
+        * @param  The mean deviation of the measurements so far.
+        * @param  The new measurement.
+     * */
+    static void Smooth(
+        long long &mean,
+        long long &deviation,
+        long long measurement)
+    {
+        long long error = measurement - mean;
+
+        mean += error / (1 << EZX_LATCH_MEAN_SHIFT);
+        deviation += ((error < 0 ? -error : error) - deviation) / (1 << EZX_LATCH_DEVIATION_SHIFT);
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    LatchStatistics::LatchStatistics()
+        : latches(0),
+          missedDeadlines(0),
+          readCost(0),
+          readCostDeviation(0),
+          wakeError(0),
+          wakeErrorDeviation(0),
+          framePeriod(0),
+          frameWork(0),
+          frameWorkDeviation(0),
+          latencyCount(0),
+          latencyTotal(0),
+          latencyMax(0),
+          latencyLast(0)
+    {
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The context to detect input with.
+     * */
+    LateLatch::LateLatch(
+        Context &context)
+        : context(&context),
+          margin(EZX_LATCH_MARGIN)
+    {
+        Reset();
+    }
+
+    /*
+     * Latch() returns bool
+     *
+        * @param  The time (see ezx::GetTimestamp()) at which the simulation consumes input,
+        *         e.g. GetNextDeadline().
+     *
+     * Sleeps until GetLatchTime(), then detects input. The thread wakes up early by the
+     * measured wake error and yields until the latch time, so a late wake up doesn't delay
+     * the sample. If the latch time has already passed the input is detected right away.
+     * Will return false if the input was detected after the deadline.
+     * */
+    bool LateLatch::Latch(
+        long long deadline)
+    {
+        long long start = GetLatchTime(deadline);
+        long long wake = start - statistics.wakeError - EZX_LATCH_DEVIATIONS * statistics.wakeErrorDeviation - EZX_LATCH_SPIN;
+        long long now = GetTimestamp();
+
+        if (now < wake)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(wake - now));
+
+            now = GetTimestamp();
+            Smooth(statistics.wakeError, statistics.wakeErrorDeviation, now > wake ? now - wake : 0);
+        }
+
+        while (now < start)
+        {
+            std::this_thread::yield();
+            now = GetTimestamp();
+        }
+
+        sampleTime = now;
+        context->DetectInput();
+
+        sampleEnd = GetTimestamp();
+        bool missed = sampleEnd > deadline;
+
+        Smooth(statistics.readCost, statistics.readCostDeviation, sampleEnd - sampleTime);
+
+        statistics.latches++;
+        presented = false;
+
+        if (missed) {
+            statistics.missedDeadlines++;
+        }
+
+        return missed == false;
+    }
+
+    /*
+     * BeginFrame() returns nothing
+     *
+        * @param  The time the frame starts, usually GetTimestamp() right after the previous
+        *         frame's present returned (i.e. aligned to the display's refresh).
+     *
+     * Measures the frame period, which GetNextDeadline() predicts the next frame from.
+     * If the previous frame was presented, records the latency from the start of its sample
+     * to now; when presenting waits for the display, that is when the frame was shown.
+     * */
+    void LateLatch::BeginFrame(
+        long long timestamp)
+    {
+        if (presented)
+        {
+            long long latency = timestamp - sampleTime;
+
+            statistics.latencyCount++;
+            statistics.latencyTotal += latency;
+            statistics.latencyLast = latency;
+
+            if (latency > statistics.latencyMax) {
+                statistics.latencyMax = latency;
+            }
+
+            presented = false;
+        }
+
+        if (frameStart != 0 && timestamp > frameStart)
+        {
+            long long period = timestamp - frameStart;
+
+            if (statistics.framePeriod == 0) {
+                statistics.framePeriod = period;
+            } else {
+                statistics.framePeriod += (period - statistics.framePeriod) / (1 << EZX_LATCH_MEAN_SHIFT);
+            }
+        }
+
+        frameStart = timestamp;
+    }
+
+    /*
+     * Present() returns nothing
+     *
+        * @param  The time the frame was handed to the display, usually GetTimestamp() right
+        *         before presenting.
+     *
+     * Records how long the frame's work took after its sample. Only the first present after
+     * each sample is counted.
+     * */
+    void LateLatch::Present(
+        long long timestamp)
+    {
+        if (presented || statistics.latches == 0) {
+            return;
+        }
+
+        Smooth(statistics.frameWork, statistics.frameWorkDeviation, timestamp - sampleEnd);
+        presented = true;
+    }
+
+    /*
+     * GetLatchTime() returns long long
+     *
+        * @param  The time at which the simulation consumes input.
+     *
+     * Returns the latest time a sample can start and still be expected to finish before the
+     * deadline: the deadline minus the margin and a conservative estimate of the read cost.
+     * */
+    long long LateLatch::GetLatchTime(
+        long long deadline) const
+    {
+        return deadline - margin - statistics.readCost - EZX_LATCH_DEVIATIONS * statistics.readCostDeviation;
+    }
+
+    /*
+     * GetNextDeadline() returns long long
+     *
+     * Returns the latest time the current frame's sample can finish: the predicted start of
+     * the next frame (from the last BeginFrame() and the measured frame period) minus the
+     * margin and a conservative estimate of the frame's work. Returns the current time until the frame
+     * timeline has been measured, so input is detected right away.
+     * */
+    long long LateLatch::GetNextDeadline() const
+    {
+        long long now = GetTimestamp();
+
+        if (frameStart == 0 || statistics.framePeriod == 0 || statistics.frameWork == 0) {
+            return now;
+        }
+
+        long long deadline = frameStart + statistics.framePeriod - margin - statistics.frameWork - EZX_LATCH_DEVIATIONS * statistics.frameWorkDeviation;
+
+        return deadline > now ? deadline : now;
+    }
+
+    /*
+     * GetSampleTime() returns long long
+     *
+     * Returns the time the last sample started.
+     * */
+    long long LateLatch::GetSampleTime() const
+    {
+        return sampleTime;
+    }
+
+    /*
+     * SetMargin() returns nothing
+     *
+        * @param  How long before the deadline samples are planned to finish, in microseconds.
+     *
+     * Defaults to EZX_LATCH_MARGIN. A larger margin misses fewer deadlines at the cost of
+     * slightly older input.
+     * */
+    void LateLatch::SetMargin(
+        long long margin)
+    {
+        this->margin = margin;
+    }
+
+    /*
+     * GetStatistics() returns nothing
+     *
+        * @param  The LatchStatistics object to copy the measurements into.
+     * */
+    void LateLatch::GetStatistics(
+        LatchStatistics *statistics) const
+    {
+        if (statistics) {
+            *statistics = this->statistics;
+        }
+    }
+
+    /*
+     * Reset() returns nothing
+     *
+     * Forgets every measurement, e.g. after the frame rate of the application changes.
+     * */
+    void LateLatch::Reset()
+    {
+        sampleTime = 0;
+        sampleEnd = 0;
+        frameStart = 0;
+        presented = false;
+        statistics = LatchStatistics();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "metrics.hpp"
+
+#include <cstring>
+
+namespace ezx
+{
+    /*
+     * Increment() returns nothing
+     *
+        * @param  The counter to increment.
+        * @param  The amount to add to the counter.
+     *
+     * Adds to a counter that is only ever written by a single thread.
+     * A relaxed load and store avoids the locked instruction of fetch_add().
+     * */
+    static inline void Increment(
+        std::atomic<unsigned long long> &counter,
+        unsigned long long amount)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    /*
+     * RaiseTo() returns nothing
+     *
+        * @param  The counter to raise.
+        * @param  The value to raise the counter to.
+     *
+     * Sets a single-writer counter to the passed value if it is greater than the current value.
+     * */
+    static inline void RaiseTo(
+        std::atomic<unsigned long long> &counter,
+        unsigned long long value)
+    {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * AtomicIncrement() returns nothing
+     *
+        * @param  The counter to increment.
+        * @param  The amount to add to the counter.
+     *
+     * Adds to a counter that may be written by several threads at once.
+     * */
+    static inline void AtomicIncrement(
+        std::atomic<unsigned long long> &counter,
+        unsigned long long amount)
+    {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /*
+     * AtomicRaiseTo() returns nothing
+     *
+        * @param  The counter to raise.
+        * @param  The value to raise the counter to.
+     *
+     * Sets a counter that may be written by several threads at once to the passed value
+     * if it is greater than the current value.
+     * */
+    static inline void AtomicRaiseTo(
+        std::atomic<unsigned long long> &counter,
+        unsigned long long value)
+    {
+        unsigned long long current = counter.load(std::memory_order_relaxed);
+
+        while (value > current)
+        {
+            if (counter.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+
+    /*
+     * LatencyBucket() returns int
+     *
+        * @param  The latency in microseconds.
+     *
+     * Converts a latency into its bucket of the read latency histogram.
+     * */
+    static inline int LatencyBucket(
+        long long latency)
+    {
+        int bucket = 0;
+
+        while (latency > 0 && bucket < EZX_LATENCY_BUCKETS-1)
+        {
+            latency >>= 1;
+            ++bucket;
+        }
+
+        return bucket;
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    Metrics::Metrics()
+    {
+        std::memset(this, 0, sizeof(Metrics));
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    MetricsCounters::MetricsCounters()
+    {
+        Reset();
+    }
+
+    /*
+     * RecordPoll() returns nothing
+     *
+        * @param  The ID of the controller that was polled.
+        * @param  How long the device read took, in microseconds.
+     *
+     * */
+    void MetricsCounters::RecordPoll(
+        short controllerID,
+        long long latency)
+    {
+        Increment(polls[controllerID], 1);
+        Increment(readLatency[LatencyBucket(latency)], 1);
+    }
+
+    /*
+     * RecordEvent() returns nothing
+     *
+        * @param  The event that was produced.
+     *
+     * */
+    void MetricsCounters::RecordEvent(
+        const Event &event)
+    {
+        int typeIndex = EZX_EVENT_TYPE_INDEX(event.type);
+
+        if (typeIndex >= 0 && typeIndex < EZX_EVENT_TYPE_COUNT && event.controllerId >= 0 && event.controllerId < 4) {
+            Increment(events[typeIndex][event.controllerId], 1);
+        }
+    }
+
+    /*
+     * RecordQueueDepth() returns nothing
+     *
+        * @param  The current number of events in the queue.
+     *
+     * */
+    void MetricsCounters::RecordQueueDepth(
+        std::size_t depth)
+    {
+        RaiseTo(queueHighWater, depth);
+    }
+
+    /*
+     * RecordDropped() returns nothing
+     *
+        * @param  The event that was dropped.
+     *
+     * */
+    void MetricsCounters::RecordDropped(
+        const Event &event)
+    {
+        int typeIndex = EZX_EVENT_TYPE_INDEX(event.type);
+
+        Increment(droppedEvents, 1);
+
+        if (typeIndex >= 0 && typeIndex < EZX_EVENT_TYPE_COUNT) {
+            Increment(droppedByType[typeIndex], 1);
+        }
+    }
+
+    /*
+     * RecordCoalesced() returns nothing
+     *
+        * @param  The number of events that were merged into an existing event.
+     *
+     * */
+    void MetricsCounters::RecordCoalesced(
+        unsigned long long count)
+    {
+        Increment(coalescedEvents, count);
+    }
+
+    /*
+     * RecordDwell() returns nothing
+     *
+        * @param  How long an event waited in the queue before being consumed, in microseconds.
+     *
+     * */
+    void MetricsCounters::RecordDwell(
+        long long dwell)
+    {
+        if (dwell < 0) {
+            dwell = 0;
+        }
+
+        AtomicIncrement(dwellCount, 1);
+        AtomicIncrement(dwellTotal, dwell);
+        AtomicRaiseTo(dwellMax, dwell);
+    }
+
+    /*
+     * Snapshot() returns nothing
+     *
+        * @param  The Metrics object to copy the counters into.
+     *
+     * Each counter is read individually, so a snapshot taken while input is being
+     * detected may mix values from slightly different points in time.
+     * */
+    void MetricsCounters::Snapshot(
+        Metrics *metrics) const
+    {
+        for (int i = 0; i < 4; ++i) {
+            metrics->polls[i] = polls[i].load(std::memory_order_relaxed);
+        }
+
+        for (int i = 0; i < EZX_LATENCY_BUCKETS; ++i) {
+            metrics->readLatency[i] = readLatency[i].load(std::memory_order_relaxed);
+        }
+
+        for (int i = 0; i < EZX_EVENT_TYPE_COUNT; ++i)
+        {
+            for (int j = 0; j < 4; ++j) {
+                metrics->events[i][j] = events[i][j].load(std::memory_order_relaxed);
+            }
+
+            metrics->droppedByType[i] = droppedByType[i].load(std::memory_order_relaxed);
+        }
+
+        metrics->queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+        metrics->droppedEvents = droppedEvents.load(std::memory_order_relaxed);
+        metrics->coalescedEvents = coalescedEvents.load(std::memory_order_relaxed);
+        metrics->dwellCount = dwellCount.load(std::memory_order_relaxed);
+        metrics->dwellTotal = dwellTotal.load(std::memory_order_relaxed);
+        metrics->dwellMax = dwellMax.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Reset() returns nothing
+     *
+     * Sets every counter back to zero.
+     * A poll, event, queue or drop counter that DetectInput() is updating at the same
+     * time may keep that one update's pre-reset value, so reset between detections
+     * for exact results.
+     * */
+    void MetricsCounters::Reset()
+    {
+        for (int i = 0; i < 4; ++i) {
+            polls[i].store(0, std::memory_order_relaxed);
+        }
+
+        for (int i = 0; i < EZX_LATENCY_BUCKETS; ++i) {
+            readLatency[i].store(0, std::memory_order_relaxed);
+        }
+
+        for (int i = 0; i < EZX_EVENT_TYPE_COUNT; ++i)
+        {
+            for (int j = 0; j < 4; ++j) {
+                events[i][j].store(0, std::memory_order_relaxed);
+            }
+
+            droppedByType[i].store(0, std::memory_order_relaxed);
+        }
+
+        queueHighWater.store(0, std::memory_order_relaxed);
+        droppedEvents.store(0, std::memory_order_relaxed);
+        coalescedEvents.store(0, std::memory_order_relaxed);
+        dwellCount.store(0, std::memory_order_relaxed);
+        dwellTotal.store(0, std::memory_order_relaxed);
+        dwellMax.store(0, std::memory_order_relaxed);
+    }
+}
\ No newline at end of file
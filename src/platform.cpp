@@ -0,0 +1,206 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "platform.hpp"
+
+#ifdef _WIN32
+
+#include <chrono>
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+     * */
+    InputWaiter::InputWaiter()
+        : woken(false)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Destructor
+     *
+     * */
+    InputWaiter::~InputWaiter()
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Wait() returns unsigned int
+     *
+        * @param  The longest time to wait in microseconds, or a negative number to wait until woken.
+        * @param  Whether new input should end the wait; has no effect on Windows.
+     *
+     * Returns a mask of the controller slots that have new input, which is always zero
+     * since XInput cannot signal it.
+     * */
+    unsigned int InputWaiter::Wait(
+        long long timeout,
+        bool)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (timeout < 0) {
+            condition.wait(lock, [this] { return woken; });
+        } else {
+            condition.wait_for(lock, std::chrono::microseconds(timeout), [this] { return woken; });
+        }
+
+        woken = false;
+        return 0;
+    }
+
+    /*
+     * Wake() returns nothing
+     *
+     * Ends the current (or next) call to Wait().
+     * */
+    void InputWaiter::Wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            woken = true;
+        }
+
+        condition.notify_all();
+    }
+
+    /*
+     * IsEventDriven() returns bool
+     *
+     * Returns true if Wait() ends as soon as new input is available.
+     * */
+    bool InputWaiter::IsEventDriven()
+    {
+        return false;
+    }
+}
+
+#else
+
+#include "evdev.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+     * */
+    InputWaiter::InputWaiter()
+        : wakeDescriptor(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Destructor
+     *
+     * */
+    InputWaiter::~InputWaiter()
+    {
+        if (wakeDescriptor >= 0) {
+            close(wakeDescriptor);
+        }
+    }
+
+    /*
+     * Wait() returns unsigned int
+     *
+        * @param  The longest time to wait in microseconds, or a negative number to wait until woken.
+        * @param  Whether new input should end the wait.
+     *
+     * When watching input, also waits on the epoll descriptor of the default evdev backend,
+     * which becomes readable as soon as any device has input to read or a device is plugged
+     * in. That input is read before returning, so the descriptor does not stay readable and
+     * end the next wait at once. Returns a mask of the controller slots (bit N for slot N)
+     * that had input.
+     *
+     * Contexts that read from another backend don't watch input: nothing they call drains
+     * the evdev descriptor, and they should not open /dev/input at all.
+     * */
+    unsigned int InputWaiter::Wait(
+        long long timeout,
+        bool watchInput)
+    {
+        struct pollfd descriptors[2];
+        unsigned int slots = 0;
+
+        descriptors[0].fd = wakeDescriptor;
+        descriptors[0].events = POLLIN;
+        descriptors[0].revents = 0;
+
+        if (watchInput)
+        {
+            descriptors[1].fd = GetDefaultBackend().GetFileDescriptor();
+            descriptors[1].events = POLLIN;
+            descriptors[1].revents = 0;
+        }
+
+        poll(descriptors, watchInput ? 2 : 1, timeout < 0 ? -1 : (int)((timeout + 999) / 1000));
+
+        if (descriptors[0].revents & POLLIN)
+        {
+            eventfd_t value;
+            eventfd_read(wakeDescriptor, &value);
+        }
+
+        if (watchInput && (descriptors[1].revents & POLLIN)) {
+            GetDefaultBackend().Pump(0, &slots);
+        }
+
+        return slots;
+    }
+
+    /*
+     * Wake() returns nothing
+     *
+     * Ends the current (or next) call to Wait().
+     * */
+    void InputWaiter::Wake()
+    {
+        eventfd_write(wakeDescriptor, 1);
+    }
+
+    /*
+     * IsEventDriven() returns bool
+     *
+     * Returns true if Wait() ends as soon as new input is available.
+     * */
+    bool InputWaiter::IsEventDriven()
+    {
+        return true;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "remap.hpp"
+#include "buttonindex.hpp"
+
+/*
+ * Marks a button that is not reported at all.
+ * */
+#define EZX_UNMAPPED 0xFF
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+     * */
+    ButtonMap::ButtonMap()
+    {
+        Reset();
+    }
+
+    /*
+     * MapButton() returns bool
+     *
+        * @param  The button that is physically pressed, e.g. EZX_A.
+        * @param  The button it is reported as, or 0 to not report it at all.
+     *
+     * Will return false if either ID is not a single button.
+     * */
+    bool ButtonMap::MapButton(
+        int from,
+        int to)
+    {
+        if (IsSingleButton(from) == false || (to != 0 && IsSingleButton(to) == false)) {
+            return false;
+        }
+
+        buttonTargets[ButtonIndex((WORD)from)] = to == 0 ? EZX_UNMAPPED : (unsigned char)ButtonIndex((WORD)to);
+        UpdateIdentity();
+
+        return true;
+    }
+
+    /*
+     * MapAxis() returns bool
+     *
+        * @param  The axis that is physically moved, e.g. EZX_RTHUMB_Y.
+        * @param  The axis it is reported as, e.g. EZX_LTHUMB_Y.
+        * @param  Whether the value is negated. Ignored for the triggers.
+     *
+     * Stick axes can only be mapped to stick axes, and triggers to triggers.
+     * Will return false if either ID is not an analog, or if they are of different kinds.
+     * */
+    bool ButtonMap::MapAxis(
+        int from,
+        int to,
+        bool inverted)
+    {
+        short source = ButtonIDToAnalogAngleID(from);
+        short target = ButtonIDToAnalogAngleID(to);
+
+        if (source < 0 || target < 0 || (source < 2) != (target < 2)) {
+            return false;
+        }
+
+        axisSources[target] = (unsigned char)source;
+
+        if (inverted && target >= 2) {
+            invertedAxes |= (unsigned char)(1 << target);
+        } else {
+            invertedAxes &= (unsigned char)~(1 << target);
+        }
+
+        UpdateIdentity();
+
+        return true;
+    }
+
+    /*
+     * Reset() returns nothing
+     *
+     * Restores the default layout.
+     * */
+    void ButtonMap::Reset()
+    {
+        for (unsigned char i = 0; i < 16; ++i) {
+            buttonTargets[i] = i;
+        }
+
+        for (unsigned char i = 0; i < 6; ++i) {
+            axisSources[i] = i;
+        }
+
+        invertedAxes = 0;
+        identity = true;
+    }
+
+    /*
+     * IsIdentity() returns bool
+     *
+     * Returns true if the map is the default layout, in which case Remap() does nothing.
+     * */
+    bool ButtonMap::IsIdentity() const
+    {
+        return identity;
+    }
+
+    /*
+     * Remap() returns nothing
+     *
+        * @param  The gamepad state to rewrite in the layout of this map.
+     * */
+    void ButtonMap::Remap(
+        XINPUT_GAMEPAD *gamepad) const
+    {
+        if (identity) {
+            return;
+        }
+
+        WORD buttons = 0;
+
+        for (WORD bits = gamepad->wButtons & EZX_ALL_BUTTONS; bits; bits &= bits - 1)
+        {
+            unsigned char target = buttonTargets[ButtonIndex(bits & (WORD)(0 - bits))];
+
+            if (target != EZX_UNMAPPED) {
+                buttons |= (WORD)(1 << target);
+            }
+        }
+
+        BYTE triggers[2] = {gamepad->bLeftTrigger, gamepad->bRightTrigger};
+        SHORT sticks[4] = {gamepad->sThumbLX, gamepad->sThumbLY, gamepad->sThumbRX, gamepad->sThumbRY};
+        SHORT *outputs[4] = {&gamepad->sThumbLX, &gamepad->sThumbLY, &gamepad->sThumbRX, &gamepad->sThumbRY};
+
+        gamepad->wButtons = buttons;
+        gamepad->bLeftTrigger = triggers[axisSources[0]];
+        gamepad->bRightTrigger = triggers[axisSources[1]];
+
+        for (short i = 0; i < 4; ++i)
+        {
+            SHORT value = sticks[axisSources[i + 2] - 2];
+
+            if (invertedAxes & (1 << (i + 2))) {
+                value = (SHORT)(-1 - value);
+            }
+
+            *outputs[i] = value;
+        }
+    }
+
+    /*
+     * UpdateIdentity() returns nothing
+     *
+     * Works out whether the map is still the default layout.
+     * */
+    void ButtonMap::UpdateIdentity()
+    {
+        identity = invertedAxes == 0;
+
+        for (unsigned char i = 0; i < 16 && identity; ++i) {
+            identity = buttonTargets[i] == i;
+        }
+
+        for (unsigned char i = 0; i < 6 && identity; ++i) {
+            identity = axisSources[i] == i;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,551 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "statecodec.hpp"
+
+/*
+ * The order of the Exp-Golomb code used for analog deltas. Order 2 writes
+ * deltas of up to +/-2 in three bits and grows by two bits each time the range doubles.
+ * */
+#define EZX_DELTA_CODE_ORDER 2
+
+/*
+ * Buttons are written as a list of 4-bit indices when at most this many of them flipped,
+ * and as the full 16-bit mask of flipped bits otherwise.
+ * */
+#define EZX_SPARSE_BUTTONS 4
+
+namespace ezx
+{
+    /*
+     * GetAnalog() returns int
+     *
+        * @param  The state to read from.
+        * @param  The analog field, between 0-5 (left trigger, right trigger, LX, LY, RX, RY).
+     * */
+    static inline int GetAnalog(
+        const PackedState &state,
+        int field)
+    {
+        switch (field)
+        {
+        case 0:  return state.leftTrigger;
+        case 1:  return state.rightTrigger;
+        case 2:  return state.thumbLX;
+        case 3:  return state.thumbLY;
+        case 4:  return state.thumbRX;
+        default: return state.thumbRY;
+        }
+    }
+
+    /*
+     * SetAnalog() returns nothing
+     *
+        * @param  The state to write to.
+        * @param  The analog field, between 0-5 (left trigger, right trigger, LX, LY, RX, RY).
+        * @param  The value to write.
+     * */
+    static inline void SetAnalog(
+        PackedState &state,
+        int field,
+        int value)
+    {
+        switch (field)
+        {
+        case 0:  state.leftTrigger = (BYTE)value; break;
+        case 1:  state.rightTrigger = (BYTE)value; break;
+        case 2:  state.thumbLX = (SHORT)value; break;
+        case 3:  state.thumbLY = (SHORT)value; break;
+        case 4:  state.thumbRX = (SHORT)value; break;
+        default: state.thumbRY = (SHORT)value; break;
+        }
+    }
+
+    /*
+     * WriteDelta() returns nothing
+     *
+        * @param  The writer to write to.
+        * @param  The non-zero difference to write.
+     *
+     * Maps the difference onto the positive integers (1, -1, 2, -2, ...) and writes it
+     * with an Exp-Golomb code.
+     * */
+    static inline void WriteDelta(
+        BitWriter *writer,
+        int delta)
+    {
+        unsigned int zigzag = delta > 0 ? (unsigned int)(2 * delta - 2) : (unsigned int)(-2 * delta - 1);
+        unsigned int value = zigzag + (1u << EZX_DELTA_CODE_ORDER);
+        int bits = 0;
+
+        while ((value >> bits) > 1) {
+            ++bits;
+        }
+
+        writer->Write(0, bits - EZX_DELTA_CODE_ORDER);
+        writer->Write(value, bits + 1);
+    }
+
+    /*
+     * ReadDelta() returns int
+     *
+        * @param  The reader to read from.
+        * @param  The number of bits of the quantized field; no legal delta needs more.
+     *
+     * The inverse of WriteDelta(). A code that is longer than any delta of the field could
+     * be (i.e. corrupted data) sets the reader's error flag and returns zero.
+     * */
+    static inline int ReadDelta(
+        BitReader *reader,
+        int width)
+    {
+        int zeros = 0;
+
+        while (reader->Read(1) == 0)
+        {
+            if (reader->HasError() || zeros >= width)
+            {
+                reader->SetError();
+                return 0;
+            }
+
+            ++zeros;
+        }
+
+        unsigned int value = (1u << (zeros + EZX_DELTA_CODE_ORDER)) | reader->Read(zeros + EZX_DELTA_CODE_ORDER);
+        unsigned int zigzag = value - (1u << EZX_DELTA_CODE_ORDER);
+
+        return (zigzag & 1) ? -(int)((zigzag + 1) / 2) : (int)(zigzag / 2 + 1);
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    BitWriter::BitWriter()
+        : accumulator(0),
+          pendingBits(0)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Write() returns nothing
+     *
+        * @param  The value to write.
+        * @param  The number of low bits of the value to write, between 0 and 32.
+     *
+     * */
+    void BitWriter::Write(
+        unsigned int value,
+        int bits)
+    {
+        if (bits <= 0) {
+            return;
+        }
+
+        accumulator = (accumulator << bits) | (value & (0xFFFFFFFFULL >> (32 - bits)));
+        pendingBits += bits;
+
+        while (pendingBits >= 8)
+        {
+            pendingBits -= 8;
+            buffer.push_back((unsigned char)(accumulator >> pendingBits));
+        }
+    }
+
+    /*
+     * Flush() returns nothing
+     *
+     * Pads the last partial byte with zero bits so that it is included in the buffer.
+     * */
+    void BitWriter::Flush()
+    {
+        if (pendingBits > 0) {
+            Write(0, 8 - pendingBits);
+        }
+    }
+
+    /*
+     * Clear() returns nothing
+     *
+     * Empties the buffer while keeping its memory for reuse.
+     * */
+    void BitWriter::Clear()
+    {
+        buffer.clear();
+        accumulator = 0;
+        pendingBits = 0;
+    }
+
+    /*
+     * GetData() returns const unsigned char*
+     *
+     * Returns the written bytes. Call Flush() first to include the last partial byte.
+     * */
+    const unsigned char* BitWriter::GetData() const
+    {
+        return buffer.empty() ? NULL : &buffer[0];
+    }
+
+    /*
+     * GetSize() returns std::size_t
+     *
+     * Returns the number of complete bytes written.
+     * */
+    std::size_t BitWriter::GetSize() const
+    {
+        return buffer.size();
+    }
+
+    /*
+     * GetBitCount() returns std::size_t
+     *
+     * Returns the number of bits written, including those not yet flushed.
+     * */
+    std::size_t BitWriter::GetBitCount() const
+    {
+        return buffer.size() * 8 + pendingBits;
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The bytes to read.
+        * @param  The number of bytes to read.
+     * */
+    BitReader::BitReader(
+        const unsigned char *data,
+        std::size_t size)
+        : data(data),
+          size(data != NULL ? size : 0),
+          position(0),
+          error(false)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Read() returns unsigned int
+     *
+        * @param  The number of bits to read, between 0 and 32.
+     *
+     * Returns zero and sets the error flag if there are not enough bits left.
+     * */
+    unsigned int BitReader::Read(
+        int bits)
+    {
+        if (bits <= 0) {
+            return 0;
+        }
+
+        if (error || position + bits > size * 8)
+        {
+            error = true;
+            return 0;
+        }
+
+        unsigned int value = 0;
+
+        while (bits > 0)
+        {
+            int offset = (int)(position & 7);
+            int available = 8 - offset;
+            int take = bits < available ? bits : available;
+            unsigned int byte = data[position >> 3];
+
+            value = (value << take) | ((byte >> (available - take)) & ((1u << take) - 1));
+            position += take;
+            bits -= take;
+        }
+
+        return value;
+    }
+
+    /*
+     * HasError() returns bool
+     *
+     * Returns true if a read went past the end of the buffer, or SetError() was called.
+     * */
+    bool BitReader::HasError() const
+    {
+        return error;
+    }
+
+    /*
+     * SetError() returns nothing
+     *
+     * Marks the data as invalid, e.g. when a value read from it is out of range.
+     * Every later read returns zero.
+     * */
+    void BitReader::SetError()
+    {
+        error = true;
+    }
+
+    /*
+     * GetBitPosition() returns std::size_t
+     *
+     * Returns the number of bits read so far.
+     * */
+    std::size_t BitReader::GetBitPosition() const
+    {
+        return position;
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The number of low bits to drop from stick values.
+        * @param  The number of low bits to drop from trigger values.
+     * */
+    StateEncoder::StateEncoder(
+        int stickQuantization,
+        int triggerQuantization)
+        : stickQuantization(stickQuantization),
+          triggerQuantization(triggerQuantization),
+          keyframe(false)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Encode() returns nothing
+     *
+        * @param  The state of each of the four controllers.
+        * @param  The writer to append the frame to.
+     *
+     * Every frame starts with a single bit that marks keyframes, which are encoded against
+     * an all-zero state instead of the previous frame.
+     * */
+    void StateEncoder::Encode(
+        const PackedState states[4],
+        BitWriter *writer)
+    {
+        writer->Write(keyframe ? 1 : 0, 1);
+
+        if (keyframe)
+        {
+            Reset();
+            keyframe = false;
+        }
+
+        for (short i = 0; i < 4; ++i)
+        {
+            PackedState &previous = reference[i];
+            int quantized[6];
+            unsigned int changed = 0;
+
+            if (states[i].buttons != previous.buttons) {
+                changed |= 1;
+            }
+
+            for (int field = 0; field < 6; ++field)
+            {
+                int shift = field < 2 ? triggerQuantization : stickQuantization;
+                quantized[field] = GetAnalog(states[i], field) >> shift;
+
+                if (quantized[field] != (GetAnalog(previous, field) >> shift)) {
+                    changed |= 2 << field;
+                }
+            }
+
+            writer->Write(changed ? 1 : 0, 1);
+
+            if (changed == 0) {
+                continue;
+            }
+
+            writer->Write(changed, 7);
+
+            if (changed & 1)
+            {
+                WORD flipped = states[i].buttons ^ previous.buttons;
+                int count = 0;
+
+                for (WORD bits = flipped; bits; bits &= bits - 1) {
+                    ++count;
+                }
+
+                if (count <= EZX_SPARSE_BUTTONS)
+                {
+                    writer->Write(0, 1);
+                    writer->Write(count - 1, 2);
+
+                    for (int bit = 0; bit < 16; ++bit)
+                    {
+                        if (flipped & (1 << bit)) {
+                            writer->Write(bit, 4);
+                        }
+                    }
+                }
+                else
+                {
+                    writer->Write(1, 1);
+                    writer->Write(flipped, 16);
+                }
+
+                previous.buttons = states[i].buttons;
+            }
+
+            for (int field = 0; field < 6; ++field)
+            {
+                if (changed & (2 << field))
+                {
+                    int shift = field < 2 ? triggerQuantization : stickQuantization;
+
+                    WriteDelta(writer, quantized[field] - (GetAnalog(previous, field) >> shift));
+                    SetAnalog(previous, field, quantized[field] * (1 << shift));
+                }
+            }
+        }
+    }
+
+    /*
+     * ForceKeyframe() returns nothing
+     *
+     * Makes the next frame a keyframe, which can be decoded without any of the frames before
+     * it, e.g. after the stream was interrupted.
+     * */
+    void StateEncoder::ForceKeyframe()
+    {
+        keyframe = true;
+    }
+
+    /*
+     * Reset() returns nothing
+     *
+     * Forgets the previous frame, as if nothing had been encoded yet.
+     * */
+    void StateEncoder::Reset()
+    {
+        for (short i = 0; i < 4; ++i) {
+            reference[i] = PackedState();
+        }
+    }
+
+    /*
+     * GetReference() returns const PackedState*
+     *
+     * Returns the states of the last encoded frame exactly as the decoder reconstructs them.
+     * A sender that simulates locally should use these rather than the original states, so
+     * that both ends of the stream simulate the same quantized input.
+     * */
+    const PackedState* StateEncoder::GetReference() const
+    {
+        return reference;
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The number of low bits dropped from stick values by the encoder.
+        * @param  The number of low bits dropped from trigger values by the encoder.
+     * */
+    StateDecoder::StateDecoder(
+        int stickQuantization,
+        int triggerQuantization)
+        : stickQuantization(stickQuantization),
+          triggerQuantization(triggerQuantization)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Decode() returns bool
+     *
+        * @param  The reader to read the next frame from.
+        * @param  The array to store the state of each of the four controllers in.
+     *
+     * Will return false if the frame was cut short or is corrupted, in which case the decoder
+     * must be resynchronized with a keyframe.
+     * */
+    bool StateDecoder::Decode(
+        BitReader *reader,
+        PackedState states[4])
+    {
+        if (reader->Read(1)) {
+            Reset();
+        }
+
+        for (short i = 0; i < 4 && reader->HasError() == false; ++i)
+        {
+            PackedState &previous = reference[i];
+
+            if (reader->Read(1))
+            {
+                unsigned int changed = reader->Read(7);
+
+                if (changed & 1)
+                {
+                    WORD flipped = 0;
+
+                    if (reader->Read(1) == 0)
+                    {
+                        int count = (int)reader->Read(2) + 1;
+
+                        for (int bit = 0; bit < count; ++bit) {
+                            flipped |= (WORD)(1 << reader->Read(4));
+                        }
+                    } else {
+                        flipped = (WORD)reader->Read(16);
+                    }
+
+                    previous.buttons ^= flipped;
+                }
+
+                for (int field = 0; field < 6; ++field)
+                {
+                    if (changed & (2 << field))
+                    {
+                        int shift = field < 2 ? triggerQuantization : stickQuantization;
+                        int width = (field < 2 ? 8 : 16) - shift;
+                        int quantized = (GetAnalog(previous, field) >> shift) + ReadDelta(reader, width > 0 ? width : 0);
+
+                        SetAnalog(previous, field, quantized * (1 << shift));
+                    }
+                }
+            }
+
+            states[i] = previous;
+        }
+
+        return reader->HasError() == false;
+    }
+
+    /*
+     * Reset() returns nothing
+     *
+     * Forgets the previous frame, as if nothing had been decoded yet.
+     * */
+    void StateDecoder::Reset()
+    {
+        for (short i = 0; i < 4; ++i) {
+            reference[i] = PackedState();
+        }
+    }
+}
\ No newline at end of file
@@ -179,6 +179,8 @@ namespace ezx
             case EZX_LTHUMB_Y: return "Left Thumb Y";
             case EZX_RTHUMB_X: return "Right Thumb X";
             case EZX_RTHUMB_Y: return "Right Thumb Y";
+            case EZX_LSTICK: return "Left Stick";
+            case EZX_RSTICK: return "Right Stick";
             default: return "\0";
         }
     }
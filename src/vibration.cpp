@@ -0,0 +1,770 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+#include "vibration.hpp"
+#include "input.hpp"
+#include "clock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Motor speeds are cached as a single 32-bit value so that they can be compared and
+ * exchanged atomically; the left motor is stored in the upper 16 bits.
+ * */
+#define EZX_PACK_MOTORS(left, right)   ((unsigned int)(((unsigned int)(left) << 16) | (unsigned int)(right)))
+#define EZX_LEFT_MOTOR(packed)         ((WORD)((packed) >> 16))
+#define EZX_RIGHT_MOTOR(packed)        ((WORD)((packed) & 0xFFFF))
+#define EZX_MOTORS_UNKNOWN             0xFFFFFFFFFFFFFFFFULL
+
+namespace ezx
+{
+    /*
+     * class PlayingEffect
+     * An effect that was started by PlayEffect() and has not yet finished.
+     * */
+    struct PlayingEffect
+    {
+        int             id;
+        short           controllerID;
+        long long       start;
+        VibrationEffect effect;
+    };
+
+    /*
+     * class VibrationWorker
+     * Owns the cached motor state of each controller and the thread that writes it.
+     *
+     * The requested speeds are written by the game thread with a single atomic exchange,
+     * so unchanged requests never leave the calling thread. The worker thread sleeps until
+     * a request changes or an effect is started, then mixes the requested speeds with every
+     * playing effect and writes each controller whose result differs from what was last sent.
+     * It then waits one tick before mixing again, so any number of requests made during that
+     * tick are coalesced into one write per device, and effects are sampled at a fixed rate.
+     * */
+    class VibrationWorker
+    {
+    public:
+        VibrationWorker();
+        ~VibrationWorker();
+
+        void Request(short controllerID, WORD leftVibration, WORD rightVibration);
+        int  Play(short controllerID, const VibrationEffect &effect);
+        void Stop(int effectID);
+        void StopAll(short controllerID);
+        void Flush();
+        void Shutdown();
+        void Forget(short controllerID);
+        void SetTick(unsigned int milliseconds);
+
+    private:
+        std::atomic<unsigned int>       requested[4];
+        std::atomic<unsigned long long> sent[4];
+        std::atomic<bool>               pending;
+        std::atomic<unsigned int>       tick;
+
+        std::vector<PlayingEffect> effects;
+        int                        nextEffectID;
+
+        bool                    running;
+        bool                    stopping;
+        std::mutex              mutex;
+        std::mutex              writeMutex;
+        std::condition_variable wake;
+        std::thread             thread;
+
+        void Start();
+        void Join();
+        void Run();
+        void Mix(long long now, unsigned int output[4]);
+        void Write(const unsigned int output[4]);
+    };
+
+    /*
+     * The worker used by every vibration function.
+     * */
+    static VibrationWorker vibrationWorker;
+
+    /*
+     * Constructor
+     *
+     * */
+    VibrationEffect::VibrationEffect()
+        : leftLevel(0.0f),
+          rightLevel(0.0f),
+          attack(0),
+          sustain(0),
+          decay(0),
+          repeats(1),
+          interval(0)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The peak level of both motors, between 0.0 and 1.0.
+        * @param  The attack time in milliseconds.
+        * @param  The sustain time in milliseconds.
+        * @param  The decay time in milliseconds.
+     * */
+    VibrationEffect::VibrationEffect(
+        float level,
+        unsigned int attack,
+        unsigned int sustain,
+        unsigned int decay)
+        : leftLevel(level),
+          rightLevel(level),
+          attack(attack),
+          sustain(sustain),
+          decay(decay),
+          repeats(1),
+          interval(0)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The peak level of the left motor, between 0.0 and 1.0.
+        * @param  The peak level of the right motor, between 0.0 and 1.0.
+        * @param  The attack time in milliseconds.
+        * @param  The sustain time in milliseconds.
+        * @param  The decay time in milliseconds.
+     * */
+    VibrationEffect::VibrationEffect(
+        float leftLevel,
+        float rightLevel,
+        unsigned int attack,
+        unsigned int sustain,
+        unsigned int decay)
+        : leftLevel(leftLevel),
+          rightLevel(rightLevel),
+          attack(attack),
+          sustain(sustain),
+          decay(decay),
+          repeats(1),
+          interval(0)
+    {
+        /* Intentionally left blank. */
+    }
+
+    /*
+     * Period() returns unsigned int
+     *
+     * Returns the time in milliseconds between the start of two repetitions of the envelope.
+     * */
+    unsigned int VibrationEffect::Period() const
+    {
+        unsigned int length = attack + sustain + decay;
+        return interval > length ? interval : length;
+    }
+
+    /*
+     * Envelope() returns float
+     *
+        * @param  The time since the effect was started, in microseconds.
+     *
+     * Returns the envelope multiplier (between 0.0 and 1.0) at the passed time,
+     * or a negative number if the effect has finished.
+     * */
+    float VibrationEffect::Envelope(
+        long long elapsed) const
+    {
+        long long period = (long long)Period() * 1000;
+
+        if (period == 0 || (repeats != EZX_EFFECT_INFINITE && elapsed >= period * repeats)) {
+            return -1.0f;
+        }
+
+        long long local = elapsed % period;
+        long long attackEnd = (long long)attack * 1000;
+        long long sustainEnd = attackEnd + (long long)sustain * 1000;
+        long long decayEnd = sustainEnd + (long long)decay * 1000;
+
+        if (local < attackEnd) {
+            return (float)local / (float)attackEnd;
+        } else if (local < sustainEnd) {
+            return 1.0f;
+        } else if (local < decayEnd) {
+            return 1.0f - (float)(local - sustainEnd) / (float)(decayEnd - sustainEnd);
+        } else {
+            return 0.0f;
+        }
+    }
+
+    /*
+     * Constructor
+     *
+     * */
+    VibrationWorker::VibrationWorker()
+        : pending(false),
+          tick(EZX_VIBRATION_TICK),
+          nextEffectID(1),
+          running(false),
+          stopping(false)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            requested[i].store(EZX_PACK_MOTORS(0, 0));
+            sent[i].store(EZX_MOTORS_UNKNOWN);
+        }
+    }
+
+    /*
+     * Destructor
+     *
+     * Stops the worker thread without writing anything. The worker is destroyed during
+     * static destruction, when the backend the writes go through may already be gone,
+     * so pending requests are only written by an explicit Shutdown().
+     * */
+    VibrationWorker::~VibrationWorker()
+    {
+        Join();
+    }
+
+    /*
+     * Request() returns nothing
+     *
+        * @param  The ID of the controller to be vibrated.
+        * @param  The amount to vibrate the left side by, between 0 and 65535.
+        * @param  The amount to vibrate the right side by, between 0 and 65535.
+     *
+     * Records the requested motor speeds and wakes the worker thread if they changed.
+     * */
+    void VibrationWorker::Request(
+        short controllerID,
+        WORD leftVibration,
+        WORD rightVibration)
+    {
+        unsigned int packed = EZX_PACK_MOTORS(leftVibration, rightVibration);
+
+        if (controllerID < 0 || controllerID > 3 || requested[controllerID].exchange(packed) == packed) {
+            return;
+        }
+
+        if (pending.exchange(true) == false)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            Start();
+            wake.notify_one();
+        }
+    }
+
+    /*
+     * Play() returns int
+     *
+        * @param  The ID of the controller to play the effect on.
+        * @param  The effect to play.
+     *
+     * Returns the ID of the playing effect, or -1 if the controller ID is invalid.
+     * */
+    int VibrationWorker::Play(
+        short controllerID,
+        const VibrationEffect &effect)
+    {
+        if (controllerID < 0 || controllerID > 3) {
+            return -1;
+        }
+
+        PlayingEffect playing;
+        playing.controllerID = controllerID;
+        playing.start = GetTimestamp();
+        playing.effect = effect;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        playing.id = nextEffectID++;
+        effects.push_back(playing);
+
+        Start();
+        wake.notify_one();
+
+        return playing.id;
+    }
+
+    /*
+     * Stop() returns nothing
+     *
+        * @param  The ID of the effect to stop, as returned by Play().
+     *
+     * The effect's contribution is removed from the controller on the next tick.
+     * */
+    void VibrationWorker::Stop(
+        int effectID)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (std::vector<PlayingEffect>::iterator itr = effects.begin(); itr != effects.end(); itr++)
+        {
+            if (itr->id == effectID)
+            {
+                effects.erase(itr);
+                pending.store(true);
+                wake.notify_one();
+                break;
+            }
+        }
+    }
+
+    /*
+     * StopAll() returns nothing
+     *
+        * @param  The ID of the controller to stop every effect on.
+     *
+     * */
+    void VibrationWorker::StopAll(
+        short controllerID)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<PlayingEffect>::size_type previousSize = effects.size();
+
+        for (std::vector<PlayingEffect>::size_type i = effects.size(); i > 0; --i)
+        {
+            if (effects[i-1].controllerID == controllerID) {
+                effects.erase(effects.begin() + (i-1));
+            }
+        }
+
+        if (previousSize != effects.size())
+        {
+            pending.store(true);
+            wake.notify_one();
+        }
+    }
+
+    /*
+     * Flush() returns nothing
+     *
+     * Mixes and writes every changed controller immediately on the calling thread
+     * instead of waiting for the next tick of the worker thread.
+     * */
+    void VibrationWorker::Flush()
+    {
+        unsigned int output[4];
+
+        pending.store(false);
+        Mix(GetTimestamp(), output);
+        Write(output);
+    }
+
+    /*
+     * Shutdown() returns nothing
+     *
+     * Stops every playing effect and the worker thread, then writes the requests that are
+     * still pending on the calling thread. Vibration functions called afterwards start the
+     * worker thread again.
+     * */
+    void VibrationWorker::Shutdown()
+    {
+        Join();
+        Flush();
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        stopping = false;
+        running = false;
+
+        if (pending.load()) {
+            Start();
+        }
+    }
+
+    /*
+     * Forget() returns nothing
+     *
+        * @param  The ID of the controller whose cached state should be forgotten.
+     *
+     * A controller that disconnects stops vibrating, so its cached state no longer matches
+     * the device. Forgetting it makes sure the next request is written even if it matches
+     * the last request made before the disconnection.
+     * */
+    void VibrationWorker::Forget(
+        short controllerID)
+    {
+        if (controllerID >= 0 && controllerID < 4)
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+
+            requested[controllerID].store(EZX_PACK_MOTORS(0, 0));
+            sent[controllerID].store(EZX_PACK_MOTORS(0, 0));
+        }
+    }
+
+    /*
+     * SetTick() returns nothing
+     *
+        * @param  The length of a device tick in milliseconds.
+     *
+     * */
+    void VibrationWorker::SetTick(
+        unsigned int milliseconds)
+    {
+        tick.store(milliseconds > 0 ? milliseconds : 1);
+    }
+
+    /*
+     * Start() returns nothing
+     *
+     * Starts the worker thread if it is not already running.
+     * Must be called with the mutex locked.
+     * */
+    void VibrationWorker::Start()
+    {
+        if (running == false && stopping == false)
+        {
+            running = true;
+            thread = std::thread(&VibrationWorker::Run, this);
+        }
+    }
+
+    /*
+     * Join() returns nothing
+     *
+     * Stops every playing effect and waits for the worker thread to exit.
+     * */
+    void VibrationWorker::Join()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            stopping = true;
+            effects.clear();
+        }
+
+        wake.notify_one();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    /*
+     * Run() returns nothing
+     *
+     * The body of the worker thread.
+     * Ticks are scheduled against a fixed timeline so that effects are sampled at a steady
+     * rate regardless of how long the device writes take.
+     * */
+    void VibrationWorker::Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+        while (stopping == false)
+        {
+            wake.wait(lock, [this] { return stopping || pending.load() || effects.empty() == false; });
+
+            if (stopping) {
+                break;
+            }
+
+            lock.unlock();
+
+            unsigned int output[4];
+
+            pending.store(false);
+            Mix(GetTimestamp(), output);
+            Write(output);
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            next += std::chrono::milliseconds(tick.load());
+
+            if (next < now) {
+                next = now + std::chrono::milliseconds(tick.load());
+            }
+
+            std::this_thread::sleep_until(next);
+
+            lock.lock();
+        }
+    }
+
+    /*
+     * Mix() returns nothing
+     *
+        * @param  The time to sample the effects at.
+        * @param  The array to store the packed motor speeds of each controller in.
+     *
+     * Adds every playing effect to the requested speeds of its controller.
+     * Effects that have finished are removed.
+     * */
+    void VibrationWorker::Mix(
+        long long now,
+        unsigned int output[4])
+    {
+        float left[4];
+        float right[4];
+
+        for (int i = 0; i < 4; ++i)
+        {
+            unsigned int packed = requested[i].load();
+
+            left[i] = EZX_LEFT_MOTOR(packed);
+            right[i] = EZX_RIGHT_MOTOR(packed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (std::vector<PlayingEffect>::size_type i = effects.size(); i > 0; --i)
+            {
+                const PlayingEffect &playing = effects[i-1];
+                float envelope = playing.effect.Envelope(now - playing.start);
+
+                if (envelope < 0.0f) {
+                    effects.erase(effects.begin() + (i-1));
+                }
+                else
+                {
+                    left[playing.controllerID] += 65535.0f * playing.effect.leftLevel * envelope;
+                    right[playing.controllerID] += 65535.0f * playing.effect.rightLevel * envelope;
+                }
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            WORD leftVibration = (WORD)(left[i] < 65535.0f ? (left[i] > 0.0f ? left[i] : 0.0f) : 65535.0f);
+            WORD rightVibration = (WORD)(right[i] < 65535.0f ? (right[i] > 0.0f ? right[i] : 0.0f) : 65535.0f);
+
+            output[i] = EZX_PACK_MOTORS(leftVibration, rightVibration);
+        }
+    }
+
+    /*
+     * Write() returns nothing
+     *
+        * @param  The packed motor speeds of each controller.
+     *
+     * Writes the passed speeds to every controller whose speeds differ from what was last
+     * sent to it. If the write fails (e.g. the controller is not connected) the sent state
+     * becomes unknown rather than being mistaken for what the motors are doing, and a
+     * controller that was asked to vibrate is written again on the next tick, so it starts
+     * vibrating as soon as it connects. A controller whose state is unknown (it was never
+     * written, or the last write failed) is not written until it is asked to vibrate.
+     * */
+    void VibrationWorker::Write(
+        const unsigned int output[4])
+    {
+        bool retry = false;
+
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+
+            for (short i = 0; i < 4; ++i)
+            {
+                unsigned long long previous = sent[i].load();
+
+                if (previous != output[i] && (previous != EZX_MOTORS_UNKNOWN || output[i] != EZX_PACK_MOTORS(0, 0)))
+                {
+                    XINPUT_VIBRATION vibrate;
+                    ZeroMemory(&vibrate, sizeof(XINPUT_VIBRATION));
+
+                    vibrate.wLeftMotorSpeed = EZX_LEFT_MOTOR(output[i]);
+                    vibrate.wRightMotorSpeed = EZX_RIGHT_MOTOR(output[i]);
+
+                    if (XInputSetState(i, &vibrate) == ERROR_SUCCESS) {
+                        sent[i].store(output[i]);
+                    } else {
+                        sent[i].store(EZX_MOTORS_UNKNOWN);
+                        retry = retry || requested[i].load() != EZX_PACK_MOTORS(0, 0);
+                    }
+                }
+            }
+        }
+
+        if (retry && pending.exchange(true) == false)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            Start();
+            wake.notify_one();
+        }
+    }
+
+    /*
+     * FlushVibration() returns nothing
+     *
+     * Writes any pending vibration requests to the controllers before returning.
+     * */
+    void FlushVibration()
+    {
+        vibrationWorker.Flush();
+    }
+
+    /*
+     * ShutdownVibration() returns nothing
+     *
+     * Stops every effect and the vibration worker thread after writing any pending
+     * vibration requests. Should be called before the program exits, as nothing is
+     * written to the controllers during static destruction.
+     * */
+    void ShutdownVibration()
+    {
+        vibrationWorker.Shutdown();
+    }
+
+    /*
+     * PlayEffect() returns int
+     *
+        * @param  The ID of the controller to play the effect on.
+        * @param  The effect to play.
+     *
+     * Starts playing a vibration effect on top of the controller's current vibration.
+     * Returns an ID that can be passed to StopEffect(), or -1 if the controller ID is invalid.
+     * */
+    int PlayEffect(
+        short controllerID,
+        const VibrationEffect &effect)
+    {
+        return vibrationWorker.Play(controllerID, effect);
+    }
+
+    /*
+     * StopEffect() returns nothing
+     *
+        * @param  The ID of the effect to stop, as returned by PlayEffect().
+     *
+     * */
+    void StopEffect(
+        int effectID)
+    {
+        vibrationWorker.Stop(effectID);
+    }
+
+    /*
+     * StopEffects() returns nothing
+     *
+        * @param  The ID of the controller to stop every effect on.
+     *
+     * */
+    void StopEffects(
+        short controllerID)
+    {
+        vibrationWorker.StopAll(controllerID);
+    }
+
+    /*
+     * ResetVibrationCache() returns nothing
+     *
+        * @param  The ID of the controller whose cached motor state should be reset.
+     *
+     * Is called by DetectInput() when a controller disconnects.
+     * */
+    void ResetVibrationCache(
+        short controllerID)
+    {
+        vibrationWorker.Forget(controllerID);
+    }
+
+    /*
+     * SetVibrationTick() returns nothing
+     *
+        * @param  The length of a device tick in milliseconds.
+     *
+     * Sets how often the worker thread may write to each controller,
+     * which is also the rate at which effects are mixed.
+     * */
+    void SetVibrationTick(
+        unsigned int milliseconds)
+    {
+        vibrationWorker.SetTick(milliseconds);
+    }
+
+    /*
+     * SetVibrationAmount() returns nothing
+     *
+        * @param  The ID of the controller to be vibrated.
+        * @param  The amount to vibrate both sides by, between 0 and 65535.
+     *
+     * */
+    void SetVibrationAmount(
+        short controllerID,
+        WORD vibration)
+    {
+        SetVibrationAmount(controllerID, vibration, vibration);
+    }
+
+    /*
+     * SetVibrationAmount() returns nothing
+     *
+        * @param  The ID of the controller to be vibrated.
+        * @param  The amount to vibrate the left side by, between 0 and 65535.
+        * @param  The amount to vibrate the right side by, between 0 and 65535.
+     *
+     * Requests that match the last request for the controller are dropped; changes are
+     * written to the controller by the vibration worker thread (see FlushVibration()).
+     * */
+    void SetVibrationAmount(
+        short controllerID,
+        WORD leftVibration,
+        WORD rightVibration)
+    {
+        vibrationWorker.Request(controllerID, leftVibration, rightVibration);
+    }
+
+    /*
+     * SetVibrationLevel() returns nothing
+     *
+        * @param  The ID of the controller to be vibrated.
+        * @param  The amount to vibrate both sides by, between 0.0 and 1.0.
+     *
+     * */
+    void SetVibrationLevel(
+        short controllerID,
+        float vibrationPercentage)
+    {
+        WORD vibration = (WORD)(65535.0f * vibrationPercentage);
+        SetVibrationAmount(controllerID, vibration, vibration);
+    }
+
+    /*
+     * SetVibrationLevel() returns nothing
+     *
+        * @param  The ID of the controller to be vibrated.
+        * @param  The amount to vibrate the left side by, between 0.0 and 1.0.
+        * @param  The amount to vibrate the right side by, between 0.0 and 1.0.
+     *
+     * */
+    void SetVibrationLevel(
+        short controllerID,
+        float leftVibrationPercentage,
+        float rightVibrationPercentage)
+    {
+        WORD leftVibration = (WORD)(65535.0f * leftVibrationPercentage);
+        WORD rightVibration = (WORD)(65535.0f * rightVibrationPercentage);
+
+        SetVibrationAmount(controllerID, leftVibration, rightVibration);
+    }
+}
\ No newline at end of file
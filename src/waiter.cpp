@@ -0,0 +1,117 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+
+#include "waiter.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+
+namespace ezx
+{
+    /*
+     * Constructor
+     *
+        * @param  The event type, e.g. EZX_PRESS, or EZX_ANY.
+        * @param  The ID of the controller, or EZX_ANY.
+        * @param  The ID of the input, e.g. EZX_A, or EZX_ANY.
+        * @param  Whether only the first EZX_PRESS of each hold of a button matches.
+     * */
+    EventFilter::EventFilter(
+        short type,
+        short controllerId,
+        int which,
+        bool initialPress)
+        : type(type),
+          controllerId(controllerId),
+          which(which),
+          initialPress(initialPress)
+    {
+    }
+
+    /*
+     * Matches() returns bool
+     *
+        * @param  The event to check.
+     *
+     * Checks the type, controller and input of the event. (Whether a press is the initial
+     * one is checked by the context, which knows when each button was pressed.)
+     * */
+    bool EventFilter::Matches(
+        const Event &event) const
+    {
+        return (type == EZX_ANY || type == event.type)
+            && (controllerId == EZX_ANY || controllerId == event.controllerId)
+            && (which == EZX_ANY || which == event.which);
+    }
+
+    /*
+     * IsValid() returns bool
+     *
+     * Will return false if the type is not an event type, the controller ID is not between
+     * 0-3, or the input ID is neither a button, axis or stick ID nor (for connection events)
+     * a controller ID. EZX_ANY is valid for each of them.
+     * */
+    bool EventFilter::IsValid() const
+    {
+        if (type != EZX_ANY && ((type & 0xFF) || EZX_EVENT_TYPE_INDEX(type) < 0 || EZX_EVENT_TYPE_INDEX(type) >= EZX_EVENT_TYPE_COUNT)) {
+            return false;
+        }
+
+        if (controllerId != EZX_ANY && (controllerId < 0 || controllerId > 3)) {
+            return false;
+        }
+
+        if (which == EZX_ANY || IdToName(which)[0] != '\0') {
+            return true;
+        }
+
+        return (type == EZX_ANY || type == EZX_CONNECT || type == EZX_DISCONNECT) && which >= 0 && which <= 3;
+    }
+
+    /*
+     * Constructor
+     *
+        * @param  The events to wait for.
+     * */
+    EventWaiter::EventWaiter(
+        const EventFilter &filter)
+        : filter(filter),
+          previous(NULL),
+          next(NULL),
+          waiting(false)
+    {
+    }
+
+    /*
+     * GetFilter() returns const EventFilter&
+     *
+     * */
+    const EventFilter& EventWaiter::GetFilter() const
+    {
+        return filter;
+    }
+}
\ No newline at end of file
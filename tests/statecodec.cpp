@@ -0,0 +1,398 @@
+/*
+* EasyXInput
+* https://github.com/TylerOBrien/EasyXInput
+*
+* Copyright (c) 2012 Tyler O'Brien
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* */
+
+/*
+ * Round-trip tests of ezx::StateEncoder and ezx::StateDecoder.
+ * Every stream is written to and read back from an in-memory buffer.
+ * */
+
+#include "statecodec.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#define EZX_CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+
+namespace
+{
+    int failures = 0;
+
+    typedef std::vector< std::vector<ezx::PackedState> > Frames;
+
+    const WORD  BUTTON_EXTREMES[] = {0x0000, 0xFFFF, EZX_ALL_BUTTONS, 0x0001, 0x8000};
+    const BYTE  TRIGGER_EXTREMES[] = {0, 255};
+    const SHORT STICK_EXTREMES[] = {0, -32768, 32767};
+
+    /*
+     * Check() returns bool
+     *
+        * @param  The result of the checked expression.
+        * @param  The text of the checked expression.
+        * @param  The file the check is in.
+        * @param  The line the check is on.
+     *
+     * */
+    bool Check(
+        bool passed,
+        const char *expression,
+        const char *file,
+        int line)
+    {
+        if (passed == false)
+        {
+            std::printf("%s:%d: check failed: %s\n", file, line, expression);
+            ++failures;
+        }
+
+        return passed;
+    }
+
+    /*
+     * MakeState() returns ezx::PackedState
+     *
+        * @param  The button mask.
+        * @param  The left and right trigger values.
+        * @param  The four stick axes (LX, LY, RX, RY).
+     *
+     * */
+    ezx::PackedState MakeState(
+        WORD buttons,
+        BYTE leftTrigger,
+        BYTE rightTrigger,
+        SHORT thumbLX,
+        SHORT thumbLY,
+        SHORT thumbRX,
+        SHORT thumbRY)
+    {
+        ezx::PackedState state;
+
+        state.buttons = buttons;
+        state.leftTrigger = leftTrigger;
+        state.rightTrigger = rightTrigger;
+        state.thumbLX = thumbLX;
+        state.thumbLY = thumbLY;
+        state.thumbRX = thumbRX;
+        state.thumbRY = thumbRY;
+
+        return state;
+    }
+
+    /*
+     * ExtremeFrames() returns Frames
+     *
+     * Returns one frame for every combination of the extreme button masks, trigger values
+     * and stick values. The first controller walks through the combinations in order and
+     * the other three walk through them at different offsets, so that every controller
+     * sees both small and full-range jumps between extremes.
+     * */
+    Frames ExtremeFrames()
+    {
+        std::vector<ezx::PackedState> combinations;
+
+        for (int b = 0; b < 5; ++b)
+        for (int lt = 0; lt < 2; ++lt)
+        for (int rt = 0; rt < 2; ++rt)
+        for (int lx = 0; lx < 3; ++lx)
+        for (int ly = 0; ly < 3; ++ly)
+        for (int rx = 0; rx < 3; ++rx)
+        for (int ry = 0; ry < 3; ++ry)
+        {
+            combinations.push_back(MakeState(
+                BUTTON_EXTREMES[b], TRIGGER_EXTREMES[lt], TRIGGER_EXTREMES[rt],
+                STICK_EXTREMES[lx], STICK_EXTREMES[ly], STICK_EXTREMES[rx], STICK_EXTREMES[ry]));
+        }
+
+        Frames frames(combinations.size(), std::vector<ezx::PackedState>(4));
+
+        for (std::size_t i = 0; i < combinations.size(); ++i)
+        {
+            for (short j = 0; j < 4; ++j) {
+                frames[i][j] = combinations[(i * (2 * j + 1) + j * 97) % combinations.size()];
+            }
+        }
+
+        return frames;
+    }
+
+    /*
+     * Quantize() returns ezx::PackedState
+     *
+        * @param  The state to quantize.
+        * @param  The number of low bits dropped from stick values.
+        * @param  The number of low bits dropped from trigger values.
+     *
+     * Returns the state the way the decoder reconstructs it.
+     * */
+    ezx::PackedState Quantize(
+        const ezx::PackedState &state,
+        int stickQuantization,
+        int triggerQuantization)
+    {
+        return MakeState(state.buttons,
+            (BYTE)((state.leftTrigger >> triggerQuantization) << triggerQuantization),
+            (BYTE)((state.rightTrigger >> triggerQuantization) << triggerQuantization),
+            (SHORT)((state.thumbLX >> stickQuantization) * (1 << stickQuantization)),
+            (SHORT)((state.thumbLY >> stickQuantization) * (1 << stickQuantization)),
+            (SHORT)((state.thumbRX >> stickQuantization) * (1 << stickQuantization)),
+            (SHORT)((state.thumbRY >> stickQuantization) * (1 << stickQuantization)));
+    }
+
+    /*
+     * Encode() returns nothing
+     *
+        * @param  The frames to encode.
+        * @param  The encoder to use.
+        * @param  The writer to append the frames to; it is flushed afterwards.
+     *
+     * */
+    void Encode(
+        const Frames &frames,
+        ezx::StateEncoder *encoder,
+        ezx::BitWriter *writer)
+    {
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            encoder->Encode(&frames[i][0], writer);
+        }
+
+        writer->Flush();
+    }
+
+    /*
+     * TestRoundTrip() returns nothing
+     *
+        * @param  The number of low bits dropped from stick values.
+        * @param  The number of low bits dropped from trigger values.
+     *
+     * Encodes every extreme frame into one buffer and decodes it again. Without
+     * quantization the states must come back exactly; with it they must match
+     * the quantized input and the encoder's reference.
+     * */
+    void TestRoundTrip(
+        int stickQuantization,
+        int triggerQuantization)
+    {
+        Frames frames = ExtremeFrames();
+        ezx::StateEncoder encoder(stickQuantization, triggerQuantization);
+        ezx::StateDecoder decoder(stickQuantization, triggerQuantization);
+        ezx::BitWriter writer;
+
+        Encode(frames, &encoder, &writer);
+
+        ezx::BitReader reader(writer.GetData(), writer.GetSize());
+        std::size_t mismatches = 0;
+
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            ezx::PackedState states[4];
+
+            if (EZX_CHECK(decoder.Decode(&reader, states)) == false) {
+                return;
+            }
+
+            for (short j = 0; j < 4; ++j)
+            {
+                if (states[j] != Quantize(frames[i][j], stickQuantization, triggerQuantization)) {
+                    ++mismatches;
+                }
+            }
+        }
+
+        EZX_CHECK(mismatches == 0);
+        EZX_CHECK(reader.GetBitPosition() <= writer.GetBitCount());
+        EZX_CHECK(writer.GetBitCount() - reader.GetBitPosition() < 8);
+
+        ezx::PackedState last[4];
+        ezx::BitReader empty(NULL, 0);
+
+        EZX_CHECK(decoder.Decode(&empty, last) == false);
+
+        for (short j = 0; j < 4; ++j) {
+            EZX_CHECK(encoder.GetReference()[j] == Quantize(frames.back()[j], stickQuantization, triggerQuantization));
+        }
+    }
+
+    /*
+     * TestDisconnect() returns nothing
+     *
+     * A disconnected controller is sent as an all-zero state. Going from every field at its
+     * extreme to that state and back must round trip, and must not disturb the other
+     * controllers. An unchanged frame must cost one bit per controller plus the keyframe bit.
+     * */
+    void TestDisconnect()
+    {
+        ezx::PackedState held = MakeState(0xFFFF, 255, 255, -32768, 32767, 32767, -32768);
+        Frames frames(4, std::vector<ezx::PackedState>(4, held));
+
+        frames[1][2] = ezx::PackedState();
+        frames[2][2] = ezx::PackedState();
+
+        ezx::StateEncoder encoder(0, 0);
+        ezx::StateDecoder decoder(0, 0);
+        ezx::BitWriter writer;
+        std::size_t sizes[4];
+
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            std::size_t before = writer.GetBitCount();
+
+            encoder.Encode(&frames[i][0], &writer);
+            sizes[i] = writer.GetBitCount() - before;
+        }
+
+        writer.Flush();
+
+        EZX_CHECK(sizes[2] == 5);
+
+        ezx::BitReader reader(writer.GetData(), writer.GetSize());
+
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            ezx::PackedState states[4];
+
+            EZX_CHECK(decoder.Decode(&reader, states));
+
+            for (short j = 0; j < 4; ++j) {
+                EZX_CHECK(states[j] == frames[i][j]);
+            }
+        }
+    }
+
+    /*
+     * TestKeyframe() returns nothing
+     *
+     * A decoder that joins the stream at a keyframe must reconstruct the same states as one
+     * that decoded the stream from the start.
+     * */
+    void TestKeyframe()
+    {
+        Frames frames = ExtremeFrames();
+        ezx::StateEncoder encoder;
+        ezx::BitWriter head;
+        ezx::BitWriter tail;
+
+        frames.resize(64);
+
+        for (std::size_t i = 0; i < 32; ++i) {
+            encoder.Encode(&frames[i][0], &head);
+        }
+
+        encoder.ForceKeyframe();
+
+        for (std::size_t i = 32; i < frames.size(); ++i) {
+            encoder.Encode(&frames[i][0], &tail);
+        }
+
+        tail.Flush();
+
+        ezx::StateDecoder decoder;
+        ezx::BitReader reader(tail.GetData(), tail.GetSize());
+        ezx::PackedState states[4];
+
+        for (std::size_t i = 32; i < frames.size(); ++i) {
+            EZX_CHECK(decoder.Decode(&reader, states));
+        }
+
+        for (short j = 0; j < 4; ++j) {
+            EZX_CHECK(states[j] == encoder.GetReference()[j]);
+        }
+    }
+
+    /*
+     * TestTruncated() returns nothing
+     *
+     * Cutting the buffer short at any byte must make a Decode() fail instead of reading past
+     * the end, and every frame decoded before the failure must still be correct.
+     * A delta code that is too long to be valid must be rejected before the data runs out.
+     * */
+    void TestTruncated()
+    {
+        Frames frames = ExtremeFrames();
+        ezx::StateEncoder encoder(0, 0);
+        ezx::BitWriter writer;
+
+        frames.resize(48);
+        Encode(frames, &encoder, &writer);
+
+        std::vector<unsigned char> data(writer.GetData(), writer.GetData() + writer.GetSize());
+
+        for (std::size_t size = 0; size < data.size(); ++size)
+        {
+            std::vector<unsigned char> truncated(data.begin(), data.begin() + size);
+            ezx::StateDecoder decoder(0, 0);
+            ezx::BitReader reader(truncated.empty() ? NULL : &truncated[0], truncated.size());
+            bool failed = false;
+
+            for (std::size_t i = 0; i < frames.size() && failed == false; ++i)
+            {
+                ezx::PackedState states[4];
+
+                if (decoder.Decode(&reader, states) == false) {
+                    failed = true;
+                    continue;
+                }
+
+                for (short j = 0; j < 4; ++j) {
+                    EZX_CHECK(states[j] == frames[i][j]);
+                }
+            }
+
+            EZX_CHECK(failed);
+        }
+
+        /*
+         * Not a keyframe, the first controller changed its left trigger, and then a delta
+         * code with more leading zeros than any 8-bit trigger delta can need.
+         * */
+        unsigned char corrupted[8] = {0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+        ezx::StateDecoder decoder(0, 0);
+        ezx::BitReader reader(corrupted, sizeof(corrupted));
+        ezx::PackedState states[4];
+
+        EZX_CHECK(decoder.Decode(&reader, states) == false);
+        EZX_CHECK(reader.GetBitPosition() < sizeof(corrupted) * 8);
+    }
+}
+
+int main()
+{
+    for (int quantization = 0; quantization <= 4; ++quantization) {
+        TestRoundTrip(quantization, 0);
+    }
+
+    TestRoundTrip(EZX_STICK_QUANTIZATION, 2);
+    TestDisconnect();
+    TestKeyframe();
+    TestTruncated();
+
+    if (failures > 0)
+    {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    std::printf("All state codec tests passed\n");
+    return 0;
+}
\ No newline at end of file